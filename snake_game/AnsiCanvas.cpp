@@ -0,0 +1,31 @@
+#include "AnsiCanvas.h"
+#include <cstdio>
+#include <cstring>
+
+void AnsiCanvas::put(int y, int x, const char* text) {
+    if (y != cursorY || x != cursorX) {
+        char move[16];
+        int n = std::snprintf(move, sizeof(move), "\x1b[%d;%dH", y + 1, x + 1);
+        bytes.append(move, n);
+    }
+    std::size_t length = std::strlen(text);
+    bytes.append(text, length);
+    cursorY = y;
+    cursorX = x + int(length);
+}
+
+void AnsiCanvas::clear() {
+    bytes += "\x1b[H\x1b[2J";
+    cursorY = cursorX = 0;
+}
+
+void AnsiCanvas::begin() {
+    bytes += "\x1b[?25l";
+    clear();
+}
+
+void AnsiCanvas::end() {
+    bytes += "\x1b[?25h\x1b[0m";
+    cursorY = cursorX = -1;
+    put(rows - 1, 0, "\r\n");
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include "Canvas.h"
+
+// ANSI 이스케이프로 프레임을 바이트 버퍼에 쓰는 Canvas (ncurses/stdscr 없이 소켓이나 pty로 보낼 때).
+// 커서가 이미 그 자리에 있으면 이동 명령을 생략하므로, 한 줄을 이어서 찍으면 글자만 들어간다.
+// 보낸 만큼 consume으로 앞에서 덜어 낸다. 터미널 크기는 알 수 없으므로 만들 때 정한다.
+class AnsiCanvas : public Canvas {
+public:
+    AnsiCanvas(int rows = 24, int cols = 80) : rows(rows), cols(cols) {}
+
+    void put(int y, int x, const char* text) override;
+    void clear() override;
+    void flush() override {}  // 버퍼를 가져가는 쪽이 보낸다
+    int getRows() const override { return rows; }
+    int getCols() const override { return cols; }
+
+    // 터미널을 처음 받았을 때 / 돌려줄 때 (커서 숨김, 화면 지움 / 커서 보임)
+    void begin();
+    void end();
+
+    const char* data() const { return bytes.data(); }
+    std::size_t size() const { return bytes.size(); }
+    void consume(std::size_t n) { bytes.erase(0, n); }  // 앞에서 n바이트 (보낸 만큼)
+
+private:
+    std::string bytes;
+    int rows, cols;
+    int cursorY = -1, cursorX = -1;  // 모르면 -1
+};
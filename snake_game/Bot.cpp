@@ -0,0 +1,76 @@
+#include "Bot.h"
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN
+const int dx[4] = {0, 0, -1, 1}; // LEFT, RIGHT
+const Direction kOpposite[4] = {DOWN, UP, RIGHT, LEFT};
+
+bool isDeadly(const Map& map, int idx, int length) {
+    int cell = map.at(idx);
+    if (cell == WALL || cell == IMMUNE_WALL || map.isOccupied(idx))
+        return true;
+    // 길이 3에서 독을 먹으면 죽는다
+    return cell == POISON_ITEM && length <= 3;
+}
+
+// 목표 칸들 중 가장 가까운 곳까지의 맨해튼 거리
+int distanceTo(const Map& map, int idx, const std::vector<int>& targets) {
+    int best = INT_MAX;
+    int y = map.rowOf(idx), x = map.colOf(idx);
+    for (int target : targets) {
+        int d = std::abs(map.rowOf(target) - y) + std::abs(map.colOf(target) - x);
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+} // namespace
+
+Direction chooseBotDirection(const Game& game) {
+    int length = game.getSnake().getLength();
+    CellList goal = LIST_GATE;
+    if (game.getGrowthCount() < 3 && length + 1 < game.getMaxLength())
+        goal = LIST_GROWTH;
+    else if (game.getPoisonCount() < 2 && length > 3)
+        goal = LIST_POISON;
+    return chooseBotDirection(game.getMap(), game.getSnake(), goal);
+}
+
+Direction chooseBotDirection(const Map& map, const Snake& snake, CellList goal) {
+    Direction current = snake.getDirection();
+    int head = snake.getBody().frontCell();
+    int length = snake.getLength();
+    const std::vector<int>& targets = map.cellsOf(goal);
+
+    // 현재 방향을 먼저 보고, 같은 점수면 먼저 본 방향을 유지한다
+    const Direction order[4] = {current, static_cast<Direction>((current + 1) % 4),
+                                static_cast<Direction>((current + 2) % 4),
+                                static_cast<Direction>((current + 3) % 4)};
+    Direction best = current;
+    long bestScore = LONG_MAX;
+    for (Direction dir : order) {
+        if (dir == kOpposite[current]) continue;
+
+        int next = head + dy[dir] * map.getStride() + dx[dir];
+        if (isDeadly(map, next, length)) continue;
+
+        // 다음 칸에서 더 나갈 곳이 없으면 막다른 길로 본다 (게이트는 반대편으로 나간다)
+        int exits = map.at(next) == GATE ? 1 : 0;
+        for (int d = 0; d < 4 && map.at(next) != GATE; ++d) {
+            int around = next + dy[d] * map.getStride() + dx[d];
+            if (around != head && !isDeadly(map, around, length)) ++exits;
+        }
+
+        long score = targets.empty() ? 0 : distanceTo(map, next, targets);
+        if (exits == 0) score += 1L << 20;
+        score = score * 8 - exits;
+        if (score < bestScore) {
+            bestScore = score;
+            best = dir;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "Game.h"
+
+// 배치 실행과 자동 플레이에 쓰는 간단한 탐욕 정책.
+// 미션 순서(성장 -> 독 -> 게이트)대로 목표를 정하고, 바로 죽지 않는 방향 중
+// 목표에 가장 가까워지는 쪽을 고른다. 상태가 없어서 여러 스레드에서 동시에 불러도 된다.
+Direction chooseBotDirection(const Game& game);
+
+// 목표 칸 종류를 직접 정해서 고른다 (미션이 없는 여러 뱀 경기에서 쓴다).
+// 다른 뱀의 몸통도 같은 점유 표시에 있으므로 따로 볼 필요가 없다.
+Direction chooseBotDirection(const Map& map, const Snake& snake, CellList goal);
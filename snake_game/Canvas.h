@@ -0,0 +1,12 @@
+#pragma once
+
+// 렌더러가 글자를 찍는 출력 대상
+class Canvas {
+public:
+    virtual ~Canvas() = default;
+    virtual void put(int y, int x, const char* text) = 0;
+    virtual void clear() = 0;
+    virtual void flush() = 0;  // 한 프레임 출력이 끝났을 때
+    virtual int getRows() const = 0;  // 출력할 수 있는 줄 수
+    virtual int getCols() const = 0;  // 한 줄의 글자 수
+};
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 4096칸짜리 타일 단위로 fill이 아닌 칸이 있는 곳만 메모리를 잡는 2차원 격자.
+// 셀 인덱스는 row * stride + col이고 stride는 2의 거듭제곱이라 시프트와 마스크로 타일을 찾는다.
+// 타일은 폭 min(stride, 64)칸이라 좁은 맵에서는 연속된 행 묶음이 된다.
+// 할당되지 않은 타일은 fill로 채운 공용 타일을 가리키고, fill이 아닌 값을 쓸 때 그 타일을 새로 만든다.
+// 타일마다 fill이 아닌 칸 수를 세어 두고 0이 되면 돌려준다 (하나는 다음 할당용으로 남긴다).
+// 작은 격자는 dense로 만들어서 타일 없이 연속 배열 하나에 인덱스로 바로 접근한다.
+template <typename T>
+class ChunkedGrid {
+public:
+    static const int kTileShift = 12;
+    static const int kTileCells = 1 << kTileShift;
+
+    ChunkedGrid() = default;
+    ChunkedGrid(const ChunkedGrid& other) { *this = other; }
+
+    // 모양이 같으면 이미 잡아 둔 타일을 다시 써서 복사 중 할당을 줄인다
+    ChunkedGrid& operator=(const ChunkedGrid& other) {
+        if (this == &other) return *this;
+        denseCells = other.denseCells;
+        dense = other.dense ? denseCells.data() : nullptr;
+        if (owned.size() != other.owned.size())
+            owned.clear();
+        setShape(other.dense ? 0 : other.rows, other.strideShift, other.fill);
+        rows = other.rows;
+        live = other.live;
+        for (std::size_t t = 0; t < owned.size(); ++t) {
+            const T* src = other.owned[t].get();
+            if (src) {
+                if (!owned[t]) owned[t] = newTile();
+                std::copy(src, src + kTileCells, owned[t].get());
+                tiles[t] = owned[t].get();
+            } else if (owned[t]) {
+                std::fill(owned[t].get(), owned[t].get() + kTileCells, fill);
+                release(t);
+            }
+        }
+        return *this;
+    }
+
+    // rows행, 행 폭 1 << shift인 격자를 fill로 초기화한다. 타일은 모두 버린다.
+    void reset(int rowCount, int shift, T value, bool denseGrid) {
+        owned.clear();
+        spare.reset();
+        if (denseGrid) {
+            denseCells.assign(std::size_t(rowCount) << shift, value);
+            dense = denseCells.data();
+            setShape(0, shift, value);
+        } else {
+            denseCells = std::vector<T>();
+            dense = nullptr;
+            setShape(rowCount, shift, value);
+        }
+        rows = rowCount;
+    }
+
+    // 모든 칸을 fill로 되돌린다
+    void clear() {
+        std::fill(denseCells.begin(), denseCells.end(), fill);
+        for (std::size_t t = 0; t < owned.size(); ++t) {
+            if (!owned[t]) continue;
+            std::fill(owned[t].get(), owned[t].get() + kTileCells, fill);
+            release(t);
+        }
+    }
+
+    T get(int idx) const {
+        if (dense) return dense[idx];
+        return tiles[tileOf(idx)][offsetOf(idx)];
+    }
+
+    void set(int idx, T value) {
+        if (dense)
+            dense[idx] = value;
+        else
+            setTiled(idx, value);
+    }
+
+    // 호출하는 쪽이 격자 종류를 이미 알 때. Dense면 분기 없이 배열을 바로 읽고 쓴다.
+    template <bool Dense>
+    T read(int idx) const { return Dense ? dense[idx] : get(idx); }
+    template <bool Dense>
+    void write(int idx, T value) {
+        if (Dense)
+            dense[idx] = value;
+        else
+            set(idx, value);
+    }
+
+    bool isDense() const { return dense != nullptr; }
+    bool hasShapeOf(const ChunkedGrid& other) const {
+        return rows == other.rows && strideShift == other.strideShift && isDense() == other.isDense();
+    }
+    // 실제로 잡은 칸 수 (dense면 전체)
+    std::size_t getAllocatedCells() const {
+        std::size_t tileCount = std::count_if(owned.begin(), owned.end(),
+                                              [](const auto& t) { return t != nullptr; });
+        return denseCells.size() + tileCount * kTileCells;
+    }
+    // forEachTile이 넘기는 영역의 크기 (dense면 격자 전체가 한 영역)
+    int getTileRows() const { return dense ? rows : 1 << tileRowShift; }
+    int getTileCols() const { return dense ? 1 << strideShift : 1 << tileWidthShift; }
+
+    // 할당된 타일마다 f(첫 행, 첫 열)을 부른다
+    template <typename F>
+    void forEachTile(F f) const {
+        if (dense) {
+            f(0, 0);
+            return;
+        }
+        for (std::size_t t = 0; t < owned.size(); ++t) {
+            if (owned[t])
+                f(int(t >> tileColShift) << tileRowShift, int(t & tileColMask) << tileWidthShift);
+        }
+    }
+
+private:
+    std::vector<T*> tiles;                    // 타일마다 실제 칸 (할당 전에는 fillTile)
+    std::vector<std::unique_ptr<T[]>> owned;  // 할당한 타일 (없으면 nullptr)
+    std::vector<int> live;                    // 타일마다 fill이 아닌 칸 수
+    std::unique_ptr<T[]> fillTile;            // fill로만 채운 읽기 전용 타일
+    std::unique_ptr<T[]> spare;               // 돌려받은 타일 하나 (fill로 채워져 있다)
+    std::vector<T> denseCells;                // dense 격자의 칸
+    T* dense = nullptr;
+    int rows = 0;
+    int strideShift = 0;
+    int tileWidthShift = 0;  // 타일 폭 = min(stride, 64)
+    int tileRowShift = 0;    // 타일 높이 = 4096 / 타일 폭
+    int tileColShift = 0;    // 한 줄에 놓이는 타일 수 = stride / 타일 폭
+    unsigned strideMask = 0, tileColMask = 0;
+    unsigned tileRowMask = 0, tileWidthMask = 0;
+    T fill = T();
+
+    void setShape(int rowCount, int shift, T value) {
+        rows = rowCount;
+        strideShift = shift;
+        tileWidthShift = std::min(shift, 6);
+        tileRowShift = kTileShift - tileWidthShift;
+        tileColShift = shift - tileWidthShift;
+        strideMask = (1u << shift) - 1;
+        tileColMask = (1u << tileColShift) - 1;
+        tileRowMask = (1u << tileRowShift) - 1;
+        tileWidthMask = (1u << tileWidthShift) - 1;
+        if (!fillTile || fill != value) {
+            fillTile.reset(new T[kTileCells]);
+            std::fill(fillTile.get(), fillTile.get() + kTileCells, value);
+            spare.reset();
+        }
+        fill = value;
+        std::size_t tileRowCount = (std::size_t(rows) + tileRowMask) >> tileRowShift;
+        owned.resize(tileRowCount << tileColShift);
+        live.assign(owned.size(), 0);
+        tiles.assign(owned.size(), fillTile.get());
+        for (std::size_t t = 0; t < owned.size(); ++t)
+            if (owned[t]) tiles[t] = owned[t].get();
+    }
+
+    // 타일 할당/반환까지 set에 인라인되면 작은 맵의 Map::setAt/occupy가 커져서 느려지므로 따로 둔다
+    __attribute__((noinline)) void setTiled(int idx, T value) {
+        std::size_t t = tileOf(idx);
+        if (!owned[t]) {
+            if (value == fill) return;
+            owned[t] = newTile();
+            tiles[t] = owned[t].get();
+        }
+        T& cell = tiles[t][offsetOf(idx)];
+        live[t] += int(value != fill) - int(cell != fill);
+        cell = value;
+        if (live[t] == 0)
+            release(t);
+    }
+
+    // fill로 채운 타일 (남겨 둔 것이 있으면 그것을 쓴다)
+    std::unique_ptr<T[]> newTile() {
+        if (spare) return std::move(spare);
+        std::unique_ptr<T[]> tile(new T[kTileCells]);
+        std::fill(tile.get(), tile.get() + kTileCells, fill);
+        return tile;
+    }
+
+    // 모든 칸이 fill로 돌아온 타일을 돌려준다
+    void release(std::size_t t) {
+        if (!spare) spare = std::move(owned[t]);
+        owned[t].reset();
+        tiles[t] = fillTile.get();
+        live[t] = 0;
+    }
+
+    std::size_t tileOf(int idx) const {
+        unsigned i = idx;
+        return (std::size_t(i >> (strideShift + tileRowShift)) << tileColShift) |
+               ((i & strideMask) >> tileWidthShift);
+    }
+    unsigned offsetOf(int idx) const {
+        unsigned i = idx;
+        return (((i >> strideShift) & tileRowMask) << tileWidthShift) | (i & tileWidthMask);
+    }
+};
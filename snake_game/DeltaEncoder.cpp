@@ -0,0 +1,88 @@
+#include "DeltaEncoder.h"
+
+void DeltaEncoder::welcome(const MultiGame& game, unsigned player, MessageWriter& out) const {
+    const Map& map = game.getMap();
+    out.begin(MSG_WELCOME);
+    out.u8(kProtocolVersion);
+    out.u8(player);
+    out.u8(game.getSnakeCount());
+    out.u32(map.getHeight());
+    out.u32(map.getWidth());
+    out.end();
+}
+
+SnakeRecord DeltaEncoder::recordOf(const MultiGame& game, int id) {
+    const MultiGame::Player& player = game.getPlayer(id);
+    SnakeRecord r;
+    if (player.isAlive()) {
+        const Map& map = game.getMap();
+        int head = player.snake.getBody().frontCell();
+        r.head = uint32_t(map.rowOf(head)) * map.getWidth() + map.colOf(head);
+        r.length = player.snake.getLength();
+    }
+    r.growth = player.growthCount;
+    r.poison = player.poisonCount;
+    r.gates = player.gateUseCount;
+    r.death = player.death;
+    return r;
+}
+
+// 빈 칸이 아닌 칸과 뱀 몸통만 보낸다 (클라이언트는 빈 맵에서 시작한다)
+void DeltaEncoder::snapshot(const MultiGame& game, MessageWriter& out) {
+    const Map& map = game.getMap();
+    out.begin(MSG_SNAPSHOT);
+    out.u32(game.getTick());
+
+    std::size_t countPos = out.reserve32();
+    uint32_t count = 0;
+    map.getFilledCells(cellBuffer);
+    for (int idx : cellBuffer) {
+        writeCell(map, idx, out);
+        ++count;
+    }
+    for (int id = 0; id < game.getSnakeCount(); ++id) {
+        const MultiGame::Player& player = game.getPlayer(id);
+        if (!player.isAlive()) continue;
+        const SnakeBody& body = player.snake.getBody();
+        for (std::size_t i = 0; i < body.size(); ++i) {
+            // 값이 있는 칸이면 위에서 주인과 함께 이미 보냈다
+            if (map.at(body.cellAt(i)) != EMPTY) continue;
+            writeCell(map, body.cellAt(i), out);
+            ++count;
+        }
+    }
+    out.patch(countPos, count);
+
+    sent.resize(game.getSnakeCount());
+    out.u8(game.getSnakeCount());
+    for (int id = 0; id < game.getSnakeCount(); ++id) {
+        sent[id] = recordOf(game, id);
+        out.record(id, sent[id]);
+    }
+    out.end();
+}
+
+void DeltaEncoder::tick(const MultiGame& game, MessageWriter& out) {
+    const Map& map = game.getMap();
+    out.begin(MSG_TICK);
+    out.u32(game.getTick());
+
+    sent.resize(game.getSnakeCount());
+    const std::vector<int>& dirty = map.getDirtyCells();
+    out.u32(dirty.size());
+    for (int idx : dirty)
+        writeCell(map, idx, out);
+
+    std::size_t countPos = out.size();
+    out.u8(0);
+    unsigned changed = 0;
+    for (int id = 0; id < game.getSnakeCount(); ++id) {
+        SnakeRecord r = recordOf(game, id);
+        if (r == sent[id]) continue;
+        sent[id] = r;
+        out.record(id, r);
+        ++changed;
+    }
+    out.patch8(countPos, changed);  // 뱀은 255마리까지라 한 바이트에 들어간다
+    out.end();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include "MultiGame.h"
+#include "Protocol.h"
+
+// 서버 쪽: MultiGame 상태를 클라이언트에 보낼 메시지로 만든다.
+// 틱 메시지는 Map이 모아 둔 변경 칸과, 지난번에 보낸 것과 달라진 뱀 기록만 담으므로
+// 크기와 만드는 시간이 맵 크기나 접속자 수가 아니라 바뀐 양에 비례한다.
+// 한 번 만든 메시지를 모든 클라이언트에 그대로 보낸다.
+class DeltaEncoder {
+public:
+    void welcome(const MultiGame& game, unsigned player, MessageWriter& out) const;
+    // 지금 상태 전체. 접속했을 때와 판이 새로 시작했을 때 보낸다.
+    void snapshot(const MultiGame& game, MessageWriter& out);
+    // 마지막 snapshot/tick 이후 바뀐 것. 보낸 뒤 game.markRendered()로 변경 칸을 비워야 한다.
+    void tick(const MultiGame& game, MessageWriter& out);
+
+    static SnakeRecord recordOf(const MultiGame& game, int id);
+
+private:
+    std::vector<SnakeRecord> sent;  // 뱀마다 마지막으로 보낸 기록
+    std::vector<int> cellBuffer;
+
+    static void writeCell(const Map& map, int idx, MessageWriter& out) {
+        out.u32(uint32_t(map.rowOf(idx)) * map.getWidth() + map.colOf(idx));
+        out.u8(map.at(idx));
+        out.u8(map.ownerAt(idx));
+    }
+};
@@ -0,0 +1,3 @@
+#pragma once
+
+enum Direction { UP = 0, DOWN, LEFT, RIGHT };
@@ -0,0 +1,8 @@
+#include "StageFile.h"
+#include "EmbeddedStageData.h"
+
+const EmbeddedStage* findEmbeddedStage(int stage) {
+    if (stage < 1 || stage > kEmbeddedStageCount)
+        return nullptr;
+    return &kEmbeddedStages[stage - 1];
+}
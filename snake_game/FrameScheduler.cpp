@@ -0,0 +1,18 @@
+#include "FrameScheduler.h"
+#include <thread>
+
+void FrameScheduler::start() {
+    deadline = Clock::now() + period;
+}
+
+void FrameScheduler::waitNextTick() {
+    ++ticks;
+    Clock::time_point now = Clock::now();
+    if (now > deadline) {
+        ++overruns;
+        deadline = now + period;
+        return;
+    }
+    std::this_thread::sleep_until(deadline);
+    deadline += period;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <chrono>
+
+// 절대 마감 시각 기준으로 틱 간격을 맞추는 스케줄러.
+// 한 틱의 작업 시간과 상관없이 다음 틱은 이전 마감 + 주기에 시작하므로 오차가 쌓이지 않는다.
+// 마감을 이미 넘겼으면(오버런) 밀린 틱을 몰아서 돌리지 않고 지금부터 다시 맞춘다.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(std::chrono::microseconds period) : period(period) {}
+
+    void start();         // 지금을 기준으로 다시 시작 (일시정지 뒤에도 부른다)
+    void waitNextTick();  // 다음 마감까지 잔다
+
+    std::chrono::microseconds getPeriod() const { return period; }
+    long getOverruns() const { return overruns; }
+    long getTicks() const { return ticks; }
+
+private:
+    std::chrono::microseconds period;
+    Clock::time_point deadline;
+    long overruns = 0;
+    long ticks = 0;
+};
@@ -0,0 +1,126 @@
+#include "Game.h"
+#include <stdexcept>
+#include <string>
+
+Game::Game(const GameConfig& config, std::shared_ptr<const StageCache> stages)
+    : config(config), stages(std::move(stages)) {
+    if (!this->stages)
+        this->stages = std::make_shared<const StageCache>(config.stageCount, config.arenaHeight,
+                                                          config.arenaWidth);
+    // 빈 맵으로는 뱀을 놓을 수 없다 (VecEnv와 같이 시작하기 전에 거절한다)
+    if (int failed = this->stages->getFailedStage())
+        throw std::runtime_error("failed to load stage " + std::to_string(failed));
+}
+
+void Game::reset(uint64_t seed) {
+    rng.seed(seed);
+    tick = 0;
+    overReason = OVER_NONE;
+    startStage(config.startStage);
+}
+
+void Game::startStage(int newStage) {
+    stage = newStage;
+    map.loadFrom(stages->getStage(stage));
+    snake.init(map, map.getSpawnY(), map.getSpawnX());
+
+    growthCount = 0;
+    poisonCount = 0;
+    gateUseCount = 0;
+    lastGrowthItemTick = tick;
+    lastPoisonItemTick = tick;
+
+    map.clearItems();
+    addItemAvoidSnake(GROWTH_ITEM);
+    addItemAvoidSnake(POISON_ITEM);
+    generateGates();
+}
+
+StepEvents Game::step(Direction action) {
+    StepEvents events;
+    if (isOver()) {
+        events.gameOver = overReason;
+        return events;
+    }
+
+    if (action != snake.getDirection() && !snake.updateDirection(action)) {
+        overReason = events.gameOver = OVER_REVERSE;
+        return events;
+    }
+
+    events.move = snake.move(map);
+
+    switch (events.move) {
+        case Snake::MOVE_DEAD:
+            overReason = events.gameOver = OVER_COLLISION;
+            return events;
+        case Snake::MOVE_GROWTH:
+            growthCount++;
+            lastGrowthItemTick = tick;
+            addItemAvoidSnake(GROWTH_ITEM);  // 즉시 새 아이템 생성
+            break;
+        case Snake::MOVE_POISON:
+            poisonCount++;
+            lastPoisonItemTick = tick;
+            addItemAvoidSnake(POISON_ITEM);  // 즉시 새 아이템 생성
+            break;
+        case Snake::MOVE_GATE:
+            gateUseCount++;
+            break;
+        default:
+            break;
+    }
+
+    if (snake.getLength() >= config.maxLength) {
+        overReason = events.gameOver = OVER_MAX_LENGTH;
+        return events;
+    }
+
+    if (checkMissionClear()) {
+        if (stage >= config.stageCount) {
+            overReason = events.gameOver = OVER_ALL_CLEARED;
+            return events;
+        }
+        events.stageCleared = true;
+        startStage(stage + 1);
+    }
+
+    ++tick;
+
+    if (tick - lastGrowthItemTick >= config.itemLifetimeTicks) {
+        map.clearItem(GROWTH_ITEM);
+        addItemAvoidSnake(GROWTH_ITEM);
+        lastGrowthItemTick = tick;
+    }
+
+    if (tick - lastPoisonItemTick >= config.itemLifetimeTicks) {
+        map.clearItem(POISON_ITEM);
+        addItemAvoidSnake(POISON_ITEM);
+        lastPoisonItemTick = tick;
+    }
+
+    return events;
+}
+
+bool Game::checkMissionClear() const {
+    return growthCount >= 3 &&
+           poisonCount >= 2 &&
+           gateUseCount >= 1;
+}
+
+// 스테이지에 정해진 쌍 수만큼 게이트 후보 벽에서 고른다
+void Game::generateGates() {
+    GateTable::pickGates(map.getGateCandidates(), map.getGatePairs(), rng, gateCells);
+    for (int idx : gateCells)
+        map.setAt(idx, GATE);
+    snake.setGates(map, gateCells);
+}
+
+void Game::addItemAvoidSnake(int itemType) {
+    // 뱀이 차지한 칸은 빈 칸 집합에서 이미 빠져 있다
+    int idx = map.randomFreeCell(rng);
+    if (idx < 0)
+        return;  // 빈 칸이 없으면 아이템을 놓지 않는다
+
+    map.setAt(idx, itemType);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Map.h"
+#include "Rng.h"
+#include "Snake.h"
+#include "StageCache.h"
+
+// 터미널/시간에 의존하지 않는 게임 규칙 엔진.
+// 한 번의 step()이 게임 한 틱이고, 화면 출력과 대기는 호출하는 쪽(GameManager 등)이 맡는다.
+
+struct GameConfig {
+    int maxLength = 10;
+    int itemLifetimeTicks = 67;  // 아이템 재배치 주기 (150ms 틱 기준 약 10초)
+    int stageCount = 4;
+    int startStage = 1;
+    int arenaHeight = 0;  // 0보다 크면 모든 스테이지를 이 크기의 빈 경기장으로 쓴다
+    int arenaWidth = 0;
+};
+
+enum GameOverReason {
+    OVER_NONE = 0,
+    OVER_COLLISION,   // 벽/몸통 충돌, 독으로 길이 부족
+    OVER_REVERSE,     // 진행 방향의 반대로 입력
+    OVER_MAX_LENGTH,  // 최대 길이 도달
+    OVER_ALL_CLEARED  // 마지막 스테이지 미션 완료
+};
+
+struct StepEvents {
+    Snake::MoveResult move = Snake::MOVE_NORMAL;
+    bool stageCleared = false;  // 미션을 달성해서 다음 스테이지를 불러왔다
+    GameOverReason gameOver = OVER_NONE;
+};
+
+class Game {
+public:
+    // stages를 넘기지 않으면 config.stageCount개 스테이지를 직접 읽는다.
+    // 게임을 여러 개 돌릴 때는 StageCache 하나를 같이 쓰면 된다.
+    explicit Game(const GameConfig& config = GameConfig(),
+                  std::shared_ptr<const StageCache> stages = nullptr);
+
+    void reset(uint64_t seed);           // 첫 스테이지부터 새 게임
+    StepEvents step(Direction action);   // 한 틱 진행. 입력이 없으면 현재 방향을 넘긴다.
+
+    bool isOver() const { return overReason != OVER_NONE; }
+    GameOverReason getOverReason() const { return overReason; }
+    bool checkMissionClear() const;
+    void markRendered() { map.clearDirty(); }  // 화면에 반영한 변경 칸을 비운다
+
+    const Map& getMap() const { return map; }
+    const Snake& getSnake() const { return snake; }
+    const GameConfig& getConfig() const { return config; }
+    int getStage() const { return stage; }
+    long getTick() const { return tick; }
+    int getGrowthCount() const { return growthCount; }
+    int getPoisonCount() const { return poisonCount; }
+    int getGateUseCount() const { return gateUseCount; }
+    int getMaxLength() const { return config.maxLength; }
+
+private:
+    GameConfig config;
+    std::shared_ptr<const StageCache> stages;
+    Map map;
+    Snake snake;
+    Rng rng;
+    std::vector<int> gateCells;  // 이번 스테이지의 게이트 (2k와 2k+1이 한 쌍)
+    int stage = 1;
+    long tick = 0;
+    int growthCount = 0;
+    int poisonCount = 0;
+    int gateUseCount = 0;
+    long lastGrowthItemTick = 0;
+    long lastPoisonItemTick = 0;
+    GameOverReason overReason = OVER_NONE;
+
+    void startStage(int newStage);
+    void generateGates();
+    void addItemAvoidSnake(int itemType);
+};
@@ -0,0 +1,133 @@
+#include "GameClient.h"
+#include "Socket.h"
+#include <ncurses.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+
+namespace {
+
+const int kPollMs = 5;  // 키 입력을 확인하는 간격
+
+} // namespace
+
+int GameClient::run() {
+    fd = connectTo(address);
+    if (fd < 0) return 1;
+
+    initscr();
+    noecho();
+    cbreak();
+    curs_set(0);
+    if (!input.start()) {
+        endwin();
+        close(fd);
+        std::fprintf(stderr, "failed to start the input thread\n");
+        return 1;
+    }
+
+    const char* endMessage = "disconnected";
+    bool running = true;
+    while (running) {
+        pollfd p = {fd, POLLIN, 0};
+        if (poll(&p, 1, kPollMs) > 0) {
+            ReceiveResult result = receive();
+            if (result == RECEIVE_CLOSED) {
+                endMessage = "server closed the connection";
+                break;
+            }
+            if (result == RECEIVE_BAD) {
+                endMessage = "bad message from server";
+                break;
+            }
+            if (result == RECEIVE_UPDATED)
+                draw();
+        }
+
+        KeyEvent event;
+        while (input.poll(event)) {
+            unsigned char dir;
+            switch (event.key) {
+                case KEY_UP:    dir = UP; break;
+                case KEY_DOWN:  dir = DOWN; break;
+                case KEY_LEFT:  dir = LEFT; break;
+                case KEY_RIGHT: dir = RIGHT; break;
+                case 'q':
+                case 'Q':
+                    endMessage = "bye";
+                    running = false;
+                    continue;
+                default:
+                    continue;
+            }
+            // 한 바이트라 소켓 버퍼가 찰 일은 없다
+            if (::send(fd, &dir, 1, MSG_NOSIGNAL) < 0 && errno != EAGAIN) {
+                endMessage = "server closed the connection";
+                running = false;
+            }
+        }
+    }
+
+    input.stop();
+    endwin();
+    close(fd);
+    std::printf("%s (%ld messages, %ld bytes)\n", endMessage, frames, bytesReceived);
+    return remote.isJoined() ? 0 : 1;
+}
+
+// 들어온 메시지를 모두 적용한다. 여러 틱이 밀려 왔으면 화면은 마지막 상태로 한 번만 그린다.
+GameClient::ReceiveResult GameClient::receive() {
+    unsigned char buffer[64 * 1024];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n == 0) return RECEIVE_CLOSED;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return RECEIVE_CLOSED;
+        }
+        in.insert(in.end(), buffer, buffer + n);
+        bytesReceived += n;
+    }
+
+    std::size_t pos = 0;
+    bool updated = false;
+    while (std::size_t size = MessageReader::frameSize(in.data() + pos, in.size() - pos)) {
+        MessageReader reader(in.data() + pos + kFrameHeader, size - kFrameHeader);
+        if (!remote.apply(in[pos], reader))
+            return RECEIVE_BAD;
+        updated = updated || in[pos] != MSG_WELCOME;
+        pos += size;
+        ++frames;
+    }
+    in.erase(in.begin(), in.begin() + pos);
+    return updated ? RECEIVE_UPDATED : RECEIVE_NONE;
+}
+
+void GameClient::draw() {
+    int focus = remote.getPlayer();
+    Renderer::ScoreBoard score;
+    if (focus >= 0) {
+        const SnakeRecord& me = remote.getSnake(focus);
+        score.length = me.length;
+        score.growth = me.growth;
+        score.poison = me.poison;
+        score.gate = me.gates;
+    } else {
+        score.length = score.growth = score.poison = score.gate = 0;
+    }
+    score.alive = remote.getAliveCount();
+    score.snakes = remote.getSnakeCount();
+    renderer.draw(remote.getMap(), remote.getHeads(), focus, score);
+
+    // 죽으면 다음 판이 시작될 때까지 안내 문구를 둔다 (새 판은 전체를 다시 그려서 지워진다)
+    if (focus < 0)
+        canvas.put(16, renderer.getPanelX(), "Spectating (all snakes taken)");
+    else if (remote.getSnake(focus).death != 0)
+        canvas.put(16, renderer.getPanelX(), "You died. Next round soon...");
+    else
+        return;
+    canvas.flush();
+}
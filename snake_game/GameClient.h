@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "InputThread.h"
+#include "NcursesCanvas.h"
+#include "RemoteGame.h"
+#include "Renderer.h"
+
+// GameServer에 붙는 터미널 클라이언트. 방향키를 한 바이트씩 보내고,
+// 받은 변경분을 RemoteGame에 적용해서 바뀐 칸만 다시 그린다. q로 나간다.
+class GameClient {
+public:
+    explicit GameClient(const std::string& address) : address(address), renderer(canvas) {}
+    int run();  // 접속하지 못했거나 서버가 이상한 메시지를 보냈으면 1
+
+private:
+    std::string address;
+    NcursesCanvas canvas;
+    Renderer renderer;
+    InputThread input;
+    RemoteGame remote;
+    int fd = -1;
+    std::vector<unsigned char> in;  // 아직 다 들어오지 않은 메시지
+    long bytesReceived = 0;
+    long frames = 0;
+
+    enum ReceiveResult { RECEIVE_NONE, RECEIVE_UPDATED, RECEIVE_CLOSED, RECEIVE_BAD };
+    ReceiveResult receive();
+    void draw();
+};
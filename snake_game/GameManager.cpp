@@ -1,285 +1,290 @@
 #include "GameManager.h"
-#include "Map.h"
-#include "Snake.h"
+#include "Bot.h"
+#include "FrameScheduler.h"
 #include <ncurses.h>
 #include <unistd.h>
-#include <random>
 #include <ctime>
-#include <iostream>
+#include <cstdio>
+#include <stdexcept>
 
-void GameManager::run() {
+namespace {
+
+const int kItemLifetimeMs = 10 * 1000;  // 아이템 재배치 주기
+
+GameConfig makeConfig(const GameOptions& options) {
+    GameConfig config;
+    config.itemLifetimeTicks = (kItemLifetimeMs + options.tickMs - 1) / options.tickMs;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    return config;
+}
+
+MultiConfig makeMultiConfig(const GameOptions& options) {
+    MultiConfig config;
+    config.snakeCount = options.bots + 1;
+    config.itemLifetimeTicks = (kItemLifetimeMs + options.tickMs - 1) / options.tickMs;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    return config;
+}
+
+const char* deathText(MultiGame::DeathCause cause) {
+    switch (cause) {
+        case MultiGame::DEATH_WALL:    return "hit a wall";
+        case MultiGame::DEATH_SELF:    return "bit yourself";
+        case MultiGame::DEATH_BODY:    return "hit another snake";
+        case MultiGame::DEATH_HEAD_ON: return "head-on crash";
+        case MultiGame::DEATH_POISON:  return "too much poison";
+        case MultiGame::DEATH_REVERSE: return "reversed";
+        default:                       return "";
+    }
+}
+
+} // namespace
+
+GameManager::GameManager(const GameOptions& options)
+    : options(options), game(makeConfig(options)), renderer(canvas) {}
+
+void GameManager::initScreen() {
     initscr();
     noecho();
     cbreak();
-    keypad(stdscr, TRUE);
     curs_set(0);
-    nodelay(stdscr, TRUE);
+    if (!input.start()) {
+        endwin();
+        throw std::runtime_error("failed to start the input thread");
+    }
+}
 
-    while (true) {
-        int currentStage = 1;
-        map.loadStage(currentStage);
-
-        Snake snake;
-        snake.init(10, 10);
-
-        growthCount = 0;
-        poisonCount = 0;
-        gateUseCount = 0;
-
-        startTime = time(nullptr);
-        lastGrowthItemTime = time(nullptr);
-        lastPoisonItemTime = time(nullptr);
-
-        const int tick_ms = 150 * 1000;
-        int frame = 0;
-
-        map.clearItems();
-        addItemAvoidSnake(GROWTH_ITEM, snake);
-        addItemAvoidSnake(POISON_ITEM, snake);
-        generateGates();
-        snake.setGateInfo(gate1, gate2);
-
-        clear();
-        map.render();
-        snake.render();
-        renderScoreBoard(snake);
-        mvprintw(15, 30, "Stage %d 2 seconds later start...", currentStage);
-        refresh();
-        sleep(2);
+void GameManager::closeScreen() {
+    input.stop();
+    endwin();
+}
 
-        bool gameOver = false;
-
-        while (!gameOver) {
-            clear();
-            map.render();
-            snake.render();
-            renderScoreBoard(snake);
-
-            int ch = getch();
-            while (ch != ERR) {
-                Direction currentDir = snake.getDirection();
-                Direction inputDir = currentDir;
-                switch (ch) {
-                    case KEY_UP:    inputDir = UP; break;
-                    case KEY_DOWN:  inputDir = DOWN; break;
-                    case KEY_LEFT:  inputDir = LEFT; break;
-                    case KEY_RIGHT: inputDir = RIGHT; break;
-                    default:        inputDir = currentDir; break;
-                }
-
-                if (inputDir != currentDir) {
-                    bool ok = snake.updateDirection(ch);
-                    if (!ok) {
-                        gameOver = true;
-                        break;
-                    }
-                    break;
-                }
-                ch = getch();
-            }
+void GameManager::run() {
+    if (options.bots > 0) {
+        runMulti();
+        return;
+    }
+    initScreen();
+
+    FrameScheduler scheduler(std::chrono::milliseconds(options.tickMs));
+
+    // 시드를 주지 않으면 현재 시각으로 시작한다
+    uint64_t seed = options.fixedSeed ? options.seed : time(nullptr);
+    bool recordFailed = false;  // 화면을 닫은 뒤에 알린다
 
-            Snake::MoveResult result = snake.move(map);
-
-            switch (result) {
-                case Snake::MOVE_DEAD:
-                    gameOver = true;
-                    break;
-                case Snake::MOVE_GROWTH:
-                    growthCount++;
-                    lastGrowthItemTime = time(nullptr);
-                    addItemAvoidSnake(GROWTH_ITEM, snake);  // 즉시 새 아이템 생성
-                    break;
-                case Snake::MOVE_POISON:
-                    poisonCount++;
-                    lastPoisonItemTime = time(nullptr);
-                    addItemAvoidSnake(POISON_ITEM, snake);  // 즉시 새 아이템 생성
-                    break;
-                case Snake::MOVE_GATE:
-                    gateUseCount++;
-                    break;
-                default:
-                    break;
+    while (true) {
+        game.reset(seed);
+        recorder.begin(game, seed++);
+        turns.clear();
+
+        showStageIntro();
+        scheduler.start();
+
+        while (!game.isOver()) {
+            Direction action = readInput(game.getSnake().getDirection());
+            recorder.recordInput(game, action);
+            StepEvents events = game.step(action);
+            recorder.recordEvents(game, events);
+
+            // 스테이지를 넘기는 틱은 이전 프레임 위에 안내 문구를 띄운다
+            if (!events.stageCleared) {
+                renderer.draw(game);
+                recordKeyLatency();
             }
 
-            if (snake.getLength() >= maxLength) {
-                mvprintw(18, 30, "Max length reached! Game Over!");
+            if (events.gameOver == OVER_MAX_LENGTH) {
+                mvprintw(18, renderer.getPanelX(), "Max length reached! Game Over!");
                 refresh();
                 sleep(2);
-                gameOver = true;
-            }
-
-            if (checkMissionClear(snake)) {
-                if (currentStage >= 5) {
-                    mvprintw(16, 30, "All stages cleared! Congrats!");
-                    refresh();
-                    sleep(3);
-                    gameOver = true;
-                } else {
-                    mvprintw(16, 30, "Mission Completed! Press 'Y' to continue.");
-                    refresh();
-
-                    int input;
-                    do {
-                        input = getch();
-                        usleep(100000);
-                    } while (input != 'Y' && input != 'y');
-
-                    mvprintw(17, 30, "Loading next stage...");
-                    refresh();
-                    sleep(1);
-
-                    currentStage++;
-                    map.loadStage(currentStage);
-
-                    // 뱀 시작 위치 새로 정하기 (예: 10, 10 또는 빈 공간 랜덤 등)
-                    snake.init(10, 10);
-
-                    growthCount = 0;
-                    poisonCount = 0;
-                    gateUseCount = 0;
-                    lastGrowthItemTime = time(nullptr);
-                    lastPoisonItemTime = time(nullptr);
-
-                    map.clearItems();
-                    addItemAvoidSnake(GROWTH_ITEM, snake);
-                    addItemAvoidSnake(POISON_ITEM, snake);
-                    generateGates();
-                    snake.setGateInfo(gate1, gate2);
-
-                    frame = 0;
-                    startTime = time(nullptr);
-
-                    clear();
-                    map.render();
-                    snake.render();
-                    renderScoreBoard(snake);
-                    mvprintw(15, 30, "Stage %d 2 seconds later start...", currentStage);
-                    refresh();
-                    sleep(2);
-                }
-            }
+            } else if (events.gameOver == OVER_ALL_CLEARED) {
+                mvprintw(16, renderer.getPanelX(), "All stages cleared! Congrats!");
+                refresh();
+                sleep(3);
+            } else if (events.stageCleared) {
+                // 엔진은 이미 다음 스테이지를 불러왔고, 화면에는 아직 이전 프레임이 남아 있다
+                mvprintw(16, renderer.getPanelX(), "Mission Completed! Press 'Y' to continue.");
+                refresh();
 
-            time_t now = time(nullptr);
+                int key;
+                do {
+                    key = waitKey();
+                } while (key != 'Y' && key != 'y');
 
-            if (now - lastGrowthItemTime >= 10) {
-                map.clearItem(GROWTH_ITEM);
-                addItemAvoidSnake(GROWTH_ITEM, snake);
-                lastGrowthItemTime = now;
-            }
+                mvprintw(17, renderer.getPanelX(), "Loading next stage...");
+                refresh();
+                sleep(1);
 
-            if (now - lastPoisonItemTime >= 10) {
-                map.clearItem(POISON_ITEM);
-                addItemAvoidSnake(POISON_ITEM, snake);
-                lastPoisonItemTime = now;
+                showStageIntro();
+                turns.clear();
+                scheduler.start();
             }
 
-            refresh();
-            usleep(tick_ms);
-            frame++;
+            scheduler.waitNextTick();
         }
 
-        // 게임 종료 후 다시 할지 묻기
-        clear();
-        mvprintw(10, 10, "Game over! Restart? (Y/N)");
-        refresh();
-
-        int choice;
-        do {
-            choice = getch();
-            usleep(100000);
-        } while (choice != 'Y' && choice != 'y' && choice != 'N' && choice != 'n');
+        if (!options.recordPath.empty() && !saveReplay(options.recordPath, recorder.getReplay()))
+            recordFailed = true;
 
-        if (choice == 'N' || choice == 'n') {
+        if (!askRestart())
             break;
-        }
     }
 
-    endwin();
-    printf("게임이 종료되었습니다.\n");
+    closeScreen();
+    if (recordFailed)
+        fprintf(stderr, "could not write replay to %s\n", options.recordPath.c_str());
+    printStats(scheduler);
 }
 
+// 0번 뱀은 방향키로, 나머지는 봇이 움직인다. 사람 뱀이 죽거나 혼자 남으면 끝.
+void GameManager::runMulti() {
+    initScreen();
 
+    FrameScheduler scheduler(std::chrono::milliseconds(options.tickMs));
+    uint64_t seed = options.fixedSeed ? options.seed : time(nullptr);
+    MultiGame match(makeMultiConfig(options));
+    std::vector<Direction> actions(match.getSnakeCount());
 
-void GameManager::generateGates() {
-    auto walls = map.getWallPositions();
-    if (walls.size() < 2) return;
+    while (true) {
+        match.reset(seed++);
+        turns.clear();
 
-    std::srand(std::time(nullptr));
-    int i = rand() % walls.size();
-    int j;
-    do {
-        j = rand() % walls.size();
-    } while (j == i);
+        renderer.invalidate();
+        renderer.draw(match, 0);
+        mvprintw(15, renderer.getPanelX(), "%d snakes, 2 seconds later start...",
+                 match.getSnakeCount());
+        refresh();
+        sleep(2);
+        renderer.invalidate();
+        scheduler.start();
+
+        while (match.getPlayer(0).isAlive() && !match.isOver()) {
+            actions[0] = readInput(match.getPlayer(0).snake.getDirection());
+            for (int id = 1; id < match.getSnakeCount(); ++id) {
+                const MultiGame::Player& bot = match.getPlayer(id);
+                if (bot.isAlive())
+                    actions[id] = chooseBotDirection(match.getMap(), bot.snake, LIST_GROWTH);
+            }
+            match.step(actions.data());
+            renderer.draw(match, 0);
+            recordKeyLatency();
+            scheduler.waitNextTick();
+        }
 
-    gate1 = walls[i];
-    gate2 = walls[j];
+        const MultiGame::Player& player = match.getPlayer(0);
+        if (player.isAlive())
+            mvprintw(16, renderer.getPanelX(), "Last snake standing! You win!");
+        else
+            mvprintw(16, renderer.getPanelX(), "You died (%s) at tick %ld.",
+                     deathText(player.death), player.deathTick);
+        refresh();
+        sleep(2);
 
-    map.setValue(gate1.first, gate1.second, GATE); // 예: 7은 게이트 표시용
-    map.setValue(gate2.first, gate2.second, GATE);
+        if (!askRestart())
+            break;
+    }
 
+    closeScreen();
+    printStats(scheduler);
 }
 
-void GameManager::renderScoreBoard(const Snake& snake) const {
-    int offsetX = 30;
-    int width = 12;
-    int height = 14;
-
-    // 사각형 세로줄
-    for (int y = 0; y < height; ++y) {
-    	if(y!=7){
-		mvprintw(y, offsetX, ".");
-		mvprintw(y, offsetX + width, ".");
-	}
-    }
+// 게임 종료 후 다시 할지 묻는다
+bool GameManager::askRestart() {
+    clear();
+    mvprintw(10, 10, "Game over! Restart? (Y/N)");
+    refresh();
 
-    // 가로줄
-    mvprintw(0, offsetX, ".............");
-    mvprintw(6, offsetX, ".............");
-    mvprintw(8, offsetX, ".............");
-    mvprintw(13, offsetX, ".............");
-
-    // 내용 출력
-    int currentLen = snake.getLength();
-    mvprintw(1, offsetX + 1, "Score Board");
-    mvprintw(2, offsetX + 1, "B: %d / %d", currentLen, maxLength);
-    mvprintw(3, offsetX + 1, "+: %d", growthCount);
-    mvprintw(4, offsetX + 1, "-: %d", poisonCount);
-    mvprintw(5, offsetX + 1, "G: %d", gateUseCount);
-
-    mvprintw(9, offsetX + 1, "Mission");
-    mvprintw(10, offsetX + 1, "+: 3 (%s)", (growthCount >= 3 ? "v" : " "));
-    mvprintw(11, offsetX + 1, "-: 2 (%s)", (poisonCount >= 2 ? "v" : " "));
-    mvprintw(12, offsetX + 1, "G: 1 (%s)", (gateUseCount >= 1 ? "v" : " "));
+    int choice;
+    do {
+        choice = waitKey();
+    } while (choice != 'Y' && choice != 'y' && choice != 'N' && choice != 'n');
+    return choice == 'Y' || choice == 'y';
 }
 
-bool GameManager::checkMissionClear(const Snake& snake) const {
-    return growthCount >= 3 &&
-           poisonCount >= 2 &&
-           gateUseCount >= 1;
+void GameManager::printStats(const FrameScheduler& scheduler) {
+    printf("게임이 종료되었습니다.\n");
+    if (latencyCount > 0)
+        printf("입력 지연: 평균 %.1f ms, 최대 %.1f ms (%ld회)\n",
+               latencySumMs / latencyCount, latencyMaxMs, latencyCount);
+    if (scheduler.getOverruns() > 0)
+        printf("틱 지연: %ld / %ld 틱\n", scheduler.getOverruns(), scheduler.getTicks());
 }
 
-void GameManager::addItemAvoidSnake(int itemType, const Snake& snake) {
-    int y, x;
-    const auto& body = snake.getBody();
-
-    while (true) {
-        y = rand() % map.getHeight();
-        x = rand() % map.getWidth();
-
-        if (map.getValue(y, x) != EMPTY)
+bool GameManager::watch(const Replay& replay) {
+    game = Game(replay.config);
+    game.reset(replay.seed);
+    ReplayPlayer player(replay);
+    std::vector<int> stages = {game.getStage()};
+
+    initScreen();
+    FrameScheduler scheduler(std::chrono::milliseconds(options.tickMs));
+    showStageIntro();
+    scheduler.start();
+
+    while (!game.isOver() && game.getTick() <= replay.result.tick) {
+        StepEvents events = game.step(player.nextAction(game));
+        if (events.stageCleared) {
+            stages.push_back(game.getStage());
+            showStageIntro();
+            scheduler.start();
             continue;
+        }
+        renderer.draw(game);
+        scheduler.waitNextTick();
+    }
+    sleep(1);
+    closeScreen();
 
-        bool overlap = false;
-        for (const auto& segment : body) {
-            if (segment.first == y && segment.second == x) {
-                overlap = true;
-                break;
-            }
+    ReplayResult result = resultOf(game, stages);
+    return result == replay.result;
+}
+
+// 들어온 방향키를 모두 전환 대기열에 넣고, 이번 틱에 적용할 수 있는 방향 하나를 꺼낸다.
+// 대기열이 비어 있으면 현재 방향 그대로.
+Direction GameManager::readInput(Direction currentDir) {
+    KeyEvent event;
+    while (input.poll(event)) {
+        switch (event.key) {
+            case KEY_UP:    turns.push(UP, currentDir, event.time); break;
+            case KEY_DOWN:  turns.push(DOWN, currentDir, event.time); break;
+            case KEY_LEFT:  turns.push(LEFT, currentDir, event.time); break;
+            case KEY_RIGHT: turns.push(RIGHT, currentDir, event.time); break;
+            default:        break;
         }
-        if (!overlap) break;
     }
 
-    map.setValue(y, x, itemType);
+    TurnQueue::Turn turn;
+    if (!turns.popValid(currentDir, turn))
+        return currentDir;
+
+    pendingKey = true;
+    pendingKeyTime = turn.time;
+    return turn.dir;
 }
 
+int GameManager::waitKey() {
+    KeyEvent event;
+    input.waitKey(event);
+    return event.key;
+}
 
+// 방향키를 읽은 시각부터 그 결과가 화면에 나갈 때까지의 시간
+void GameManager::recordKeyLatency() {
+    if (!pendingKey) return;
+    pendingKey = false;
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - pendingKeyTime).count();
+    latencySumMs += ms;
+    if (ms > latencyMaxMs) latencyMaxMs = ms;
+    ++latencyCount;
+}
+
+void GameManager::showStageIntro() {
+    renderer.invalidate();
+    renderer.draw(game);
+    mvprintw(15, renderer.getPanelX(), "Stage %d 2 seconds later start...", game.getStage());
+    refresh();
+    sleep(2);
+    renderer.invalidate();  // 안내 문구를 지우도록 다음 프레임은 전체를 다시 그린다
+}
@@ -1,28 +1,58 @@
 #pragma once
-#include <utility>
-#include <ctime>
-#include "Map.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "FrameScheduler.h"
+#include "Game.h"
+#include "InputThread.h"
+#include "MultiGame.h"
+#include "NcursesCanvas.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include "TurnQueue.h"
 
-class Snake;  // forward declaration
+// 명령행에서 받는 프런트엔드 설정
+struct GameOptions {
+    int tickMs = 150;  // 한 틱 길이 (밀리초)
+    bool fixedSeed = false;  // true면 seed로 시작해서 다시 할 때마다 1씩 늘린다
+    uint64_t seed = 0;
+    std::string recordPath;  // 비어 있지 않으면 게임이 끝날 때마다 입력 기록을 저장 (덮어씀)
+    int arenaHeight = 0;     // 0보다 크면 스테이지 파일 대신 이 크기의 빈 경기장
+    int arenaWidth = 0;
+    int bots = 0;            // 0보다 크면 봇 뱀들과 한 맵에서 겨룬다 (기록은 하지 않는다)
+};
 
+// ncurses 화면과 키 입력을 맡는 프런트엔드. 게임 규칙은 Game이 처리한다.
 class GameManager {
 public:
+    explicit GameManager(const GameOptions& options = GameOptions());
     void run();
-    void generateGates();
-    void renderScoreBoard(const Snake& snake) const;
-    bool checkMissionClear(const Snake& snake) const;
-    int currentStage = 1;
+    // 기록을 tickMs 속도로 화면에 재생하고, 기록된 결과와 같으면 true
+    bool watch(const Replay& replay);
 
 private:
-    Map map;
-    std::pair<int, int> gate1, gate2;
-    int growthCount = 0;
-    int poisonCount = 0;
-    int gateUseCount = 0;
-    int maxLength = 10;
-    time_t startTime;
-    time_t lastGrowthItemTime = 0;
-    time_t lastPoisonItemTime = 0;
-    void addItemAvoidSnake(int itemType, const Snake& snake);
+    GameOptions options;
+    Game game;
+    NcursesCanvas canvas;
+    Renderer renderer;
+    InputThread input;
+    TurnQueue turns;
+    ReplayRecorder recorder;
+
+    // 키 입력부터 화면 반영까지의 지연 통계
+    bool pendingKey = false;
+    std::chrono::steady_clock::time_point pendingKeyTime;
+    long latencyCount = 0;
+    double latencySumMs = 0;
+    double latencyMaxMs = 0;
 
+    void runMulti();
+    bool askRestart();
+    void printStats(const FrameScheduler& scheduler);
+    Direction readInput(Direction currentDir);
+    int waitKey();
+    void recordKeyLatency();
+    void showStageIntro();
+    void initScreen();
+    void closeScreen();
 };
@@ -0,0 +1,280 @@
+#include "GameServer.h"
+#include "Bot.h"
+#include "Socket.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::size_t kMaxPendingBytes = 1 << 20;  // 클라이언트 하나에 쌓아 둘 수 있는 양
+const int kReadChunk = 256;
+const int kItemLifetimeMs = 10 * 1000;  // 아이템 재배치 주기
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+MultiConfig makeMultiConfig(const ServerOptions& options) {
+    MultiConfig config;
+    config.snakeCount = options.snakes;
+    config.itemLifetimeTicks = (kItemLifetimeMs + options.tickMs - 1) / options.tickMs;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    return config;
+}
+
+} // namespace
+
+GameServer::GameServer(const ServerOptions& options)
+    : options(options), match(makeMultiConfig(options)),
+      human(match.getSnakeCount(), 0), actions(match.getSnakeCount(), RIGHT) {
+    seed = options.fixedSeed ? options.seed : time(nullptr);
+}
+
+GameServer::~GameServer() {
+    for (Client& client : clients)
+        if (client.fd >= 0) close(client.fd);
+    if (listenFd >= 0) {
+        close(listenFd);
+        removeSocketFile(options.address);
+    }
+}
+
+int GameServer::run() {
+    listenFd = listenOn(options.address);
+    if (listenFd < 0) return 1;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::printf("serving on %s: %d snakes, %d ms ticks\n", options.address.c_str(),
+                match.getSnakeCount(), options.tickMs);
+    std::fflush(stdout);
+    startMatch();
+
+    const auto period = std::chrono::milliseconds(options.tickMs);
+    auto deadline = Clock::now() + period;
+    std::vector<pollfd> fds;
+
+    while (!stopRequested) {
+        fds.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const Client& client : clients) {
+            short events = POLLIN;
+            if (client.outPos < client.out.size()) events |= POLLOUT;
+            fds.push_back({client.fd, events, 0});
+        }
+
+        // 다음 틱까지 남은 시간만큼 기다린다
+        auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+        timespec timeout = {0, 0};
+        if (wait.count() > 0) {
+            timeout.tv_sec = wait.count() / 1000000000;
+            timeout.tv_nsec = wait.count() % 1000000000;
+        }
+        if (ppoll(fds.data(), fds.size(), &timeout, nullptr) < 0 && errno != EINTR) {
+            std::perror("ppoll");
+            break;
+        }
+
+        // fds[i + 1]이 clients[i]다 (이번 반복에서 새로 붙은 클라이언트는 뒤에 붙는다)
+        std::size_t polled = fds.size() - 1;
+        for (std::size_t i = 0; i < polled; ++i) {
+            short revents = fds[i + 1].revents;
+            Client& client = clients[i];
+            if (revents & (POLLIN | POLLHUP | POLLERR)) readClient(client);
+            if (client.fd >= 0 && (revents & POLLOUT)) flush(client);
+        }
+        if (fds[0].revents & POLLIN) acceptClients();
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const Client& c) { return c.fd < 0; }),
+                      clients.end());
+
+        if (Clock::now() >= deadline) {
+            tick();
+            deadline += period;
+            if (deadline < Clock::now()) {
+                // 밀린 틱을 몰아서 돌리지 않고 지금부터 다시 맞춘다
+                deadline = Clock::now() + period;
+                ++overruns;
+            }
+        }
+    }
+
+    printStats();
+    return 0;
+}
+
+// 새 판을 시작하고 모두에게 전체 상태를 보낸다
+void GameServer::startMatch() {
+    match.reset(seed++);
+    overTicks = 0;
+    message.clear();
+    encoder.snapshot(match, message);
+    match.markRendered();
+    broadcast(message);
+    for (Client& client : clients)
+        client.turns.clear();
+}
+
+void GameServer::tick() {
+    if (match.isOver()) {
+        if (++overTicks >= options.restartDelayTicks)
+            startMatch();
+        return;
+    }
+
+    for (int id = 0; id < match.getSnakeCount(); ++id) {
+        const MultiGame::Player& player = match.getPlayer(id);
+        if (!player.isAlive()) continue;
+        actions[id] = human[id] ? player.snake.getDirection()
+                                : chooseBotDirection(match.getMap(), player.snake, LIST_GROWTH);
+    }
+    for (Client& client : clients) {
+        TurnQueue::Turn turn;
+        if (client.player < 0) continue;
+        const MultiGame::Player& player = match.getPlayer(client.player);
+        if (player.isAlive() && client.turns.popValid(player.snake.getDirection(), turn))
+            actions[client.player] = turn.dir;
+    }
+    match.step(actions.data());
+    ++ticks;
+
+    auto start = Clock::now();
+    message.clear();
+    encoder.tick(match, message);
+    match.markRendered();
+    broadcast(message);
+    broadcastNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    bytesPerTick += message.size();
+}
+
+void GameServer::broadcast(const MessageWriter& frame) {
+    for (Client& client : clients) {
+        if (client.fd >= 0)
+            send(client, frame.data(), frame.size());
+    }
+}
+
+void GameServer::acceptClients() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::perror("accept");
+            return;
+        }
+        setNonBlocking(fd);
+        setNoDelay(fd);
+
+        int player = -1;
+        for (int id = 0; id < match.getSnakeCount() && player < 0; ++id) {
+            if (!human[id]) {
+                player = id;
+                human[id] = 1;
+            }
+        }
+        clients.emplace_back();
+        clients.back().fd = fd;
+        clients.back().player = player;
+        peakClients = std::max<long>(peakClients, clients.size());
+
+        // 틱 사이라 맵은 마지막으로 보낸 틱과 같다
+        MessageWriter hello;
+        encoder.welcome(match, player < 0 ? kSpectator : player, hello);
+        encoder.snapshot(match, hello);
+        send(clients.back(), hello.data(), hello.size());
+    }
+}
+
+// 받은 바이트는 모두 방향 입력이다. 같은 틱에 여러 번 꺾으면 차례로 한 틱씩 적용한다.
+void GameServer::readClient(Client& client) {
+    unsigned char buffer[kReadChunk];
+    while (client.fd >= 0) {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            disconnect(client);
+            return;
+        }
+        if (n < 0) return;
+        if (client.player < 0) continue;
+
+        const MultiGame::Player& player = match.getPlayer(client.player);
+        auto now = Clock::now();
+        for (ssize_t i = 0; i < n; ++i) {
+            if (buffer[i] <= RIGHT && player.isAlive())
+                client.turns.push(static_cast<Direction>(buffer[i]), player.snake.getDirection(), now);
+        }
+    }
+}
+
+// 쌓인 것이 없으면 바로 보내고, 못 보낸 나머지만 클라이언트 버퍼에 복사한다
+void GameServer::send(Client& client, const unsigned char* data, std::size_t size) {
+    if (client.outPos == client.out.size()) {
+        client.out.clear();
+        client.outPos = 0;
+        while (size > 0) {
+            ssize_t n = ::send(client.fd, data, size, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    disconnect(client);
+                    return;
+                }
+                break;
+            }
+            data += n;
+            size -= n;
+        }
+        if (size == 0) return;
+    }
+    if (client.out.size() - client.outPos + size > kMaxPendingBytes) {
+        ++dropped;
+        disconnect(client);
+        return;
+    }
+    client.out.insert(client.out.end(), data, data + size);
+}
+
+void GameServer::flush(Client& client) {
+    while (client.outPos < client.out.size()) {
+        ssize_t n = ::send(client.fd, client.out.data() + client.outPos,
+                           client.out.size() - client.outPos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) disconnect(client);
+            return;
+        }
+        client.outPos += n;
+    }
+    client.out.clear();
+    client.outPos = 0;
+}
+
+// 맡은 뱀은 봇에게 돌려준다. 목록에서는 poll 반복이 끝난 뒤에 뺀다.
+void GameServer::disconnect(Client& client) {
+    if (client.fd < 0) return;
+    close(client.fd);
+    client.fd = -1;
+    if (client.player >= 0)
+        human[client.player] = 0;
+    client.player = -1;
+}
+
+void GameServer::printStats() const {
+    std::printf("\nticks      %ld (%ld overruns)\n", ticks, overruns);
+    std::printf("clients    peak %ld, dropped %ld\n", peakClients, dropped);
+    if (ticks > 0) {
+        std::printf("tick msg   %.1f bytes avg\n", double(bytesPerTick) / ticks);
+        std::printf("broadcast  %.2f us avg per tick\n", broadcastNs / ticks / 1000);
+    }
+}
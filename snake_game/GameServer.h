@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DeltaEncoder.h"
+#include "MultiGame.h"
+#include "Protocol.h"
+#include "TurnQueue.h"
+
+struct ServerOptions {
+    std::string address;       // 유닉스 소켓 경로 또는 TCP 포트 번호 (127.0.0.1)
+    int tickMs = 100;
+    int snakes = 8;            // 접속자가 없는 뱀은 봇이 움직인다
+    int arenaHeight = 0;       // 0보다 크면 stage 1 대신 빈 경기장
+    int arenaWidth = 0;
+    bool fixedSeed = false;
+    uint64_t seed = 0;
+    int restartDelayTicks = 20;  // 판이 끝나고 다음 판을 시작할 때까지
+};
+
+// 여러 뱀 경기를 돌리는 권한 있는 서버. 터미널 클라이언트는 방향 바이트만 보내고 화면은 서버가 보낸 대로 그린다.
+// 스레드 하나가 poll로 접속/입력/쓰기를 처리하고, 틱마다 변경분 메시지를 한 번만 만들어 모두에게 보낸다.
+// 접속하면 비어 있는 뱀 하나를 맡고(없으면 구경), 나가면 그 뱀은 다시 봇이 움직인다.
+// 못 받아 가는 클라이언트는 쌓인 양이 kMaxPendingBytes를 넘으면 끊는다.
+class GameServer {
+public:
+    explicit GameServer(const ServerOptions& options);
+    ~GameServer();
+
+    int run();  // SIGINT/SIGTERM을 받을 때까지 돈다. 시작하지 못하면 1
+
+private:
+    struct Client {
+        int fd = -1;
+        int player = -1;                 // 맡은 뱀 번호 (-1이면 구경)
+        TurnQueue turns;
+        std::vector<unsigned char> out;  // 아직 못 보낸 바이트 (outPos부터)
+        std::size_t outPos = 0;
+    };
+
+    ServerOptions options;
+    MultiGame match;
+    DeltaEncoder encoder;
+    MessageWriter message;
+    std::vector<Client> clients;
+    std::vector<char> human;  // 뱀마다 접속자가 맡고 있는지
+    std::vector<Direction> actions;
+    int listenFd = -1;
+    uint64_t seed = 0;
+    long overTicks = 0;
+
+    // 종료할 때 출력하는 통계
+    long ticks = 0;
+    long overruns = 0;
+    long bytesPerTick = 0;   // 틱 메시지 크기 합
+    double broadcastNs = 0;  // 틱 메시지를 만들고 보내는 데 걸린 시간 합
+    long peakClients = 0;
+    long dropped = 0;
+
+    void startMatch();
+    void tick();
+    void broadcast(const MessageWriter& frame);
+    void acceptClients();
+    void readClient(Client& client);
+    void send(Client& client, const unsigned char* data, std::size_t size);
+    void flush(Client& client);
+    void disconnect(Client& client);
+    void printStats() const;
+};
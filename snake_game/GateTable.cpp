@@ -0,0 +1,56 @@
+#include "GateTable.h"
+
+void GateTable::build(const CellType* cells, int stride, const std::vector<int>& gateCells) {
+    buildExits([cells](int idx) { return cells[idx]; }, stride, gateCells);
+}
+
+void GateTable::build(const Map& map, const std::vector<int>& gateCells) {
+    buildExits([&map](int idx) { return map.at(idx); }, map.getStride(), gateCells);
+    version = map.getLayoutVersion();
+}
+
+template <typename CellAt>
+void GateTable::buildExits(CellAt cellAt, int stride, const std::vector<int>& gateCells) {
+    gates = gateCells;
+
+    exits.resize(gates.size() * 4);
+    for (size_t g = 0; g < gates.size(); ++g) {
+        for (int d = 0; d < 4; ++d)
+            exits[g * 4 + d] = findExit(cellAt, stride, gates[g], static_cast<Direction>(d));
+    }
+
+    // 슬롯을 게이트 수의 두 배 이상으로 잡아 탐사 길이를 짧게 유지한다
+    unsigned capacity = 4;
+    slotShift = 30;
+    while (capacity < gates.size() * 2) {
+        capacity <<= 1;
+        --slotShift;
+    }
+    slotMask = capacity - 1;
+    slotKeys.assign(capacity, -1);
+    slotGates.assign(capacity, -1);
+    for (size_t g = 0; g < gates.size(); ++g) {
+        unsigned s = hash(gates[g]);
+        while (slotKeys[s] != -1 && slotKeys[s] != gates[g])
+            s = (s + 1) & slotMask;
+        slotKeys[s] = gates[g];
+        slotGates[s] = g;
+    }
+}
+
+void GateTable::pickGates(const std::vector<int>& candidates, int pairs, Rng& rng,
+                          std::vector<int>& out) {
+    out.clear();
+    int count = candidates.size();
+    if (pairs > count / 2) pairs = count / 2;
+
+    // 이미 고른 칸이 다시 나오면 버린다. 쌍 수가 후보보다 훨씬 적어서 금방 끝난다.
+    while (static_cast<int>(out.size()) < pairs * 2) {
+        int cell = candidates[rng.below(count)];
+        bool taken = false;
+        for (int g : out)
+            taken = taken || g == cell;
+        if (!taken)
+            out.push_back(cell);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include "Direction.h"
+#include "Map.h"
+
+// 게이트 쌍 여러 개의 출구 표.
+// gates[2k]와 gates[2k+1]이 한 쌍이고, 셀 인덱스 -> 게이트 번호는 오픈 어드레싱 해시로 찾는다.
+// (들어간 게이트, 들어갈 때 방향) -> (짝 게이트 옆의 나올 칸, 나갈 방향)은 미리 계산해 둔다.
+// 게이트를 놓을 때 한 번 만들고, 게이트 옆 칸이 막히거나 뚫리면 다시 만든다.
+class GateTable {
+public:
+    struct Exit {
+        int cell;       // 나올 칸 (나갈 곳이 없으면 짝 게이트 자신)
+        Direction dir;  // 나온 뒤의 진행 방향
+    };
+
+    void build(const CellType* cells, int stride, const std::vector<int>& gateCells);
+    void build(const Map& map, const std::vector<int>& gateCells);
+    // map의 통행 가능 칸 배치가 바뀌었을 때 같은 게이트로 다시 만든다
+    bool isCurrent(const Map& map) const { return version == map.getLayoutVersion(); }
+    void rebuild(const Map& map) {
+        std::vector<int> current = gates;
+        build(map, current);
+    }
+
+    int getPairCount() const { return gates.size() / 2; }
+    const std::vector<int>& getGates() const { return gates; }
+
+    // 표에 없는 칸이면 nullptr. 짝이 없는 GATE 칸(스테이지 파일에 적힌 것 등)은 벽처럼 막힌다.
+    const Exit* lookup(int entry, Direction dir) const {
+        int g = find(entry);
+        return g < 0 ? nullptr : &exits[(g ^ 1) * 4 + dir];
+    }
+
+    // 후보 칸에서 서로 다른 칸을 pairs쌍(후보가 모자라면 가능한 만큼) 골라 out에 채운다.
+    // 후보에 같은 칸이 두 번 있으면 안 된다 (Map이 스테이지를 읽을 때 중복을 지운다)
+    static void pickGates(const std::vector<int>& candidates, int pairs, Rng& rng,
+                          std::vector<int>& out);
+
+    // 진행 방향 우선, 그다음 시계 방향, 반시계 방향, 반대 방향 순으로 나갈 칸을 찾는다
+    static Exit findExit(const CellType* cells, int stride, int gate, Direction dir) {
+        return findExit([cells](int idx) { return cells[idx]; }, stride, gate, dir);
+    }
+    static Exit findExit(const Map& map, int gate, Direction dir) {
+        return findExit([&map](int idx) { return map.at(idx); }, map.getStride(), gate, dir);
+    }
+
+private:
+    std::vector<int> gates;
+    std::vector<Exit> exits;  // 게이트마다 4방향, 그 게이트로 나올 때의 출구
+    std::vector<int> slotKeys;    // 해시 슬롯의 셀 인덱스 (-1이면 빈 슬롯)
+    std::vector<int> slotGates;   // 해시 슬롯의 게이트 번호
+    unsigned slotMask = 0;
+    int slotShift = 32;
+    unsigned version = 0;
+
+    // cellAt(idx)로 칸을 읽는다. 연속 배열과 타일로 나뉜 Map을 같은 코드로 다룬다.
+    template <typename CellAt>
+    static Exit findExit(CellAt cellAt, int stride, int gate, Direction dir);
+    template <typename CellAt>
+    void buildExits(CellAt cellAt, int stride, const std::vector<int>& gateCells);
+
+    // 곱셈 해시의 상위 비트를 슬롯 번호로 쓴다
+    unsigned hash(int cell) const { return (unsigned(cell) * 0x9E3779B1u) >> slotShift; }
+    // 게이트 번호, 없으면 -1 (빈 슬롯을 만나면 멈춘다. 슬롯은 항상 반 이상 비어 있다)
+    int find(int cell) const {
+        if (slotKeys.empty()) return -1;
+        unsigned s = hash(cell);
+        while (slotKeys[s] != cell) {
+            if (slotKeys[s] < 0) return -1;
+            s = (s + 1) & slotMask;
+        }
+        return slotGates[s];
+    }
+};
+
+template <typename CellAt>
+inline GateTable::Exit GateTable::findExit(CellAt cellAt, int stride, int gate, Direction dir) {
+    static const int dy[4] = {-1, 1, 0, 0};
+    static const int dx[4] = {0, 0, -1, 1};
+    static const Direction kPriority[4][4] = {
+        {UP, RIGHT, LEFT, DOWN},   // UP
+        {DOWN, LEFT, RIGHT, UP},   // DOWN
+        {LEFT, UP, DOWN, RIGHT},   // LEFT
+        {RIGHT, DOWN, UP, LEFT},   // RIGHT
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        Direction next = kPriority[dir][i];
+        int idx = gate + dy[next] * stride + dx[next];
+        if (Map::isPassable(cellAt(idx)))
+            return {idx, next};
+    }
+    return {gate, dir};  // 이동 불가하면 제자리
+}
@@ -0,0 +1,135 @@
+#include "InputThread.h"
+#include <ncurses.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+const int kEscapeTimeoutMs = 25;  // ESC 뒤에 나머지 시퀀스를 기다리는 시간
+
+int arrowKey(unsigned char final) {
+    switch (final) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        default:  return -1;
+    }
+}
+
+} // namespace
+
+InputThread::InputThread() {
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    stopFd = eventfd(0, EFD_NONBLOCK);
+}
+
+InputThread::~InputThread() {
+    stop();
+    if (wakeFd >= 0) close(wakeFd);
+    if (stopFd >= 0) close(stopFd);
+}
+
+// stopFd가 없으면 stop()이 스레드를 깨울 수 없으므로 띄우지 않는다
+bool InputThread::start() {
+    if (wakeFd < 0 || stopFd < 0)
+        return false;
+    if (!thread.joinable())
+        thread = std::thread(&InputThread::run, this);
+    return true;
+}
+
+void InputThread::stop() {
+    if (!thread.joinable()) return;
+    // eventfd에 1을 더하는 쓰기는 카운터가 넘칠 때만 실패하는데, stopFd는 여기서만 쓴다
+    uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) != sizeof(one))
+        std::perror("input stop");
+    thread.join();
+}
+
+bool InputThread::poll(KeyEvent& event) {
+    return queue.pop(event);
+}
+
+bool InputThread::waitKey(KeyEvent& event, int timeoutMs) {
+    while (!queue.pop(event)) {
+        pollfd fd = {wakeFd, POLLIN, 0};
+        if (::poll(&fd, 1, timeoutMs) <= 0)
+            return false;
+        // 신호를 비운다. 입력 스레드가 먼저 비웠으면(EAGAIN) 큐를 다시 보면 된다
+        uint64_t count;
+        if (read(wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+            return false;
+    }
+    return true;
+}
+
+void InputThread::emit(int key, std::chrono::steady_clock::time_point time) {
+    if (!queue.push({key, time}))
+        return;  // 게임 루프가 한참 못 읽은 경우에는 새 키를 버린다
+    // 실패는 카운터가 가득 찬 경우뿐이고, 그때도 wakeFd는 이미 읽을 수 있는 상태다
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        std::perror("input wake");
+}
+
+void InputThread::run() {
+    // 0: 일반, 1: ESC 받음, 2: ESC [ 또는 ESC O 받음 (숫자/; 는 건너뛴다)
+    int state = 0;
+    std::chrono::steady_clock::time_point escapeTime;
+
+    while (true) {
+        pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {stopFd, POLLIN, 0}};
+        int ready = ::poll(fds, 2, state == 0 ? -1 : kEscapeTimeoutMs);
+        if (ready < 0) continue;
+        if (fds[1].revents & POLLIN) break;
+
+        if (ready == 0) {
+            // ESC 하나만 왔으면 ESC 키 자체로 본다. ESC [ 뒤에서 끊긴 시퀀스는 키가 아니므로 버린다
+            if (state == 1)
+                emit(27, escapeTime);
+            state = 0;
+            continue;
+        }
+        if (fds[0].revents & (POLLHUP | POLLERR)) break;
+
+        unsigned char buf[64];
+        ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (n <= 0) break;
+        auto now = std::chrono::steady_clock::now();
+
+        for (ssize_t i = 0; i < n; ++i) {
+            unsigned char c = buf[i];
+            if (state == 0) {
+                if (c == 27) {
+                    state = 1;
+                    escapeTime = now;
+                } else {
+                    emit(c, now);
+                }
+            } else if (state == 1) {
+                if (c == '[' || c == 'O') {
+                    state = 2;
+                } else if (c == 27) {
+                    emit(27, escapeTime);
+                    escapeTime = now;
+                } else {
+                    emit(27, escapeTime);
+                    emit(c, now);
+                    state = 0;
+                }
+            } else if ((c >= '0' && c <= '9') || c == ';') {
+                continue;
+            } else {
+                int key = arrowKey(c);
+                if (key >= 0) emit(key, escapeTime);
+                state = 0;
+            }
+        }
+    }
+}
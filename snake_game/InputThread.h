@@ -0,0 +1,33 @@
+#pragma once
+#include <chrono>
+#include <thread>
+#include "SpscQueue.h"
+
+// 키 하나와 그 키를 읽은 시각
+struct KeyEvent {
+    int key;  // 일반 문자 또는 ncurses KEY_UP/KEY_DOWN/KEY_LEFT/KEY_RIGHT
+    std::chrono::steady_clock::time_point time;
+};
+
+// 표준 입력을 전용 스레드에서 poll로 기다렸다가 읽어서, 방향키 이스케이프 시퀀스를 풀고
+// 시각을 붙여 잠금 없는 큐로 게임 루프에 넘긴다. ncurses getch는 쓰지 않는다.
+class InputThread {
+public:
+    InputThread();
+    ~InputThread();
+
+    bool start();  // eventfd를 만들지 못했으면 스레드를 띄우지 않고 false
+    void stop();
+
+    bool poll(KeyEvent& event);                 // 기다리지 않고 하나 꺼낸다
+    bool waitKey(KeyEvent& event, int timeoutMs = -1);  // 올 때까지 기다린다 (-1이면 무한히)
+
+private:
+    SpscQueue<KeyEvent, 256> queue;
+    int wakeFd = -1;  // 키가 들어오면 입력 스레드가 신호를 준다
+    int stopFd = -1;  // stop()이 입력 스레드를 깨운다
+    std::thread thread;
+
+    void run();
+    void emit(int key, std::chrono::steady_clock::time_point time);
+};
@@ -1,123 +1,481 @@
 #include "Map.h"
-#include <ncurses.h>
-#include <cstdlib>
-#include <ctime>
+#include "StageFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <unordered_set>
 
 
+namespace {
+const int kDefaultSpawnY = 10;  // 텍스트 스테이지의 시작 위치
+const int kDefaultSpawnX = 10;
+const long kFreeListLimit = 1 << 20;  // 안쪽 칸이 이보다 많으면 빈 칸 목록을 두지 않는다
+const int kFreeCellTries = 64;        // 큰 맵에서 무작위로 빈 칸을 찾는 횟수
+
+bool isWall(int value) {
+    return value == WALL || value == IMMUNE_WALL;
+}
+
+// 읽기 전에 .stg를 검사한다. 오래되거나 깨진 파일이 맵 밖을 쓰게 하지 않도록
+// 크기와 범위 외에 칸 값(GATE 이하인지, 넘으면 & 7로 다른 칸이 된다), 게이트 후보(안쪽 벽 칸인지),
+// 시작 위치(몸통 세 칸이 들어가는지), 테두리(WALL인지, Snake::move는 이것을 믿고 범위를 보지 않는다)까지 본다.
+bool isValidStageFile(const StageFileHeader& header, const unsigned char* bytes, size_t size) {
+    if (std::memcmp(header.magic, kStageFileMagic, sizeof(header.magic)) != 0 ||
+        header.version != kStageFileVersion || !Map::fitsIndex(header.height, header.width))
+        return false;
+
+    int h = header.height, w = header.width, fileStride = w + 2;
+    size_t cellCount = size_t(h + 2) * fileStride;
+    if (size_t(header.candidatesOffset) + size_t(header.candidateCount) * sizeof(uint32_t) > size ||
+        size_t(header.cellsOffset) + cellCount > size)
+        return false;
+    const unsigned char* grid = bytes + header.cellsOffset;
+
+    for (size_t i = 0; i < cellCount; ++i) {
+        if (grid[i] > GATE)
+            return false;
+    }
+    for (int x = 0; x < fileStride; ++x) {
+        if (grid[x] != WALL || grid[size_t(h + 1) * fileStride + x] != WALL)
+            return false;
+    }
+    for (int y = 1; y <= h; ++y) {
+        if (grid[size_t(y) * fileStride] != WALL || grid[size_t(y) * fileStride + w + 1] != WALL)
+            return false;
+    }
+
+    const unsigned char* candidates = bytes + header.candidatesOffset;
+    for (uint32_t i = 0; i < header.candidateCount; ++i) {
+        uint32_t fileIdx = loadLe32(candidates + i * sizeof(uint32_t));
+        uint32_t y = fileIdx / fileStride, x = fileIdx % fileStride;
+        if (fileIdx >= cellCount || y < 1 || y > uint32_t(h) || x < 1 || x > uint32_t(w) ||
+            !isWall(grid[fileIdx]))
+            return false;
+    }
+
+    // Snake::init은 (y, x), (y, x-1), (y, x-2)를 차지한다
+    int spawnY = header.spawnY, spawnX = header.spawnX;
+    if (spawnY < 0 || spawnY >= h || spawnX < 2 || spawnX >= w)
+        return false;
+    for (int dx = 0; dx < 3; ++dx) {
+        if (isWall(grid[size_t(spawnY + 1) * fileStride + spawnX + 1 - dx]))
+            return false;
+    }
+    return true;
+}
+
+// 텍스트 스테이지(한 행에 칸 값 숫자 하나씩)를 .stg와 같은 기준으로 검사한다.
+// 비어 있거나 행마다 칸 수가 다르거나 칸 값이 GATE를 넘으면 안 되고, 시작 위치에 몸통 세 칸이 들어가야 한다.
+// 바깥 테두리는 resize가 WALL로 두르므로 보지 않는다.
+bool isValidStageText(const std::vector<std::string>& rows, int spawnY, int spawnX) {
+    if (rows.empty() || !Map::fitsIndex(rows.size(), rows[0].size()))
+        return false;
+    for (const std::string& row : rows) {
+        if (row.size() != rows[0].size())
+            return false;
+        for (char value : row) {
+            if (value > GATE)
+                return false;
+        }
+    }
+    int h = rows.size(), w = rows[0].size();
+    if (spawnY >= h || spawnX < 2 || spawnX >= w)
+        return false;
+    for (int dx = 0; dx < 3; ++dx) {
+        if (isWall(rows[spawnY][spawnX - dx]))
+            return false;
+    }
+    return true;
+}
+}
+
+bool Map::fitsIndex(long h, long w) {
+    if (h <= 0 || w <= 0) return false;
+    long rowStride = 1;
+    while (rowStride < w + 2) rowStride <<= 1;
+    return (h + 2) * rowStride <= 0x7FFFFFFFL;
+}
+
+// 크기를 정하고 모든 칸을 EMPTY, 바깥 테두리를 WALL로 채운다
+void Map::resize(int h, int w) {
+    height = h;
+    width = w;
+    strideShift = 0;
+    while ((1 << strideShift) < width + 2) ++strideShift;
+    stride = 1 << strideShift;
+    trackFree = long(height) * width <= kFreeListLimit;
+
+    // 빈 칸 목록을 둘 만한 크기면 타일 없이 연속 배열로 둔다 (인덱스로 바로 접근)
+    cells.reset(height + 2, strideShift, EMPTY, trackFree);
+    occupancy.reset(height + 2, strideShift, 0, trackFree);
+    slot.reset(height + 2, strideShift, -1, trackFree);
+    dirtyMark.reset(height + 2, strideShift, 0, trackFree);
+
+    for (int x = -1; x <= width; ++x) {
+        cells.set(index(-1, x), WALL);
+        cells.set(index(height, x), WALL);
+    }
+    for (int y = 0; y < height; ++y) {
+        cells.set(index(y, -1), WALL);
+        cells.set(index(y, width), WALL);
+    }
+}
+
+// 테두리를 포함한 (height+2) x gridStride 배열을 안쪽 칸만 옮겨 담는다
+void Map::loadGrid(const CellType* grid, int gridStride) {
+    for (int y = 0; y < height; ++y) {
+        const CellType* row = grid + (y + 1) * gridStride + 1;
+        for (int x = 0; x < width; ++x)
+            cells.set(index(y, x), row[x]);
+    }
+}
+
+// 변환해 둔 stageN.stg가 있으면 그걸 쓰고, 없으면 stageN.txt를 파싱한다
 void Map::loadStage(int stage) {
-    mapData.clear();
+    std::string base = "stage" + std::to_string(stage);
+    if (loadStageFile(base + ".stg"))
+        return;
+    if (!loadStageText(base + ".txt"))
+        std::cerr << "Failed to load map file: " << base << ".txt" << std::endl;
+}
 
-    std::string filename = "stage" + std::to_string(stage) + ".txt";
+bool Map::loadStageText(const std::string& filename) {
     std::ifstream fin(filename);
 
     if (!fin.is_open()) {
-        std::cerr << "Failed to open map file: " << filename << std::endl;
-        return;
+        return false;
     }
 
+    std::vector<std::string> rows;
     std::string line;
     while (std::getline(fin, line)) {
-        std::vector<int> row;
+        std::string row;
         for (char c : line) {
             if (c >= '0' && c <= '9') {
                 row.push_back(c - '0');
             }
         }
         if (!row.empty())
-            mapData.push_back(row);
+            rows.push_back(row);
     }
 
     fin.close();
 
-    height = mapData.size();
-    if (height > 0)
-        width = mapData[0].size();
+    if (!isValidStageText(rows, kDefaultSpawnY, kDefaultSpawnX)) {
+        std::cerr << "Invalid stage file: " << filename << std::endl;
+        return false;
+    }
+    resize(rows.size(), rows[0].size());
 
-    srand(time(nullptr));
+    // 테두리는 WALL 센티넬, 안쪽은 스테이지 파일 내용으로 채운다
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x)
+            cells.set(index(y, x), static_cast<CellType>(rows[y][x]));
+    }
+    spawnY = kDefaultSpawnY;
+    spawnX = kDefaultSpawnX;
+    gatePairs = 1;
+    finishLoad();
+    gateCandidates = lists[LIST_WALL];
+    return true;
 }
 
-void Map::addItem(int type) {
-    int y, x;
-    for (int tries = 0; tries < 100; ++tries) {
-        y = rand() % mapData.size();
-        x = rand() % mapData[y].size();
-        if (mapData[y][x] == EMPTY) {
-            mapData[y][x] = type;
-            break;
-        }
+// 바이너리 스테이지를 mmap해서 검사한 뒤 격자를 복사한다.
+// 매핑한 바이트를 격자로 바로 쓰지 않는 것은 파일은 행 폭이 width+2인데 Map은 2의 거듭제곱 행 폭에
+// 점유/목록 격자를 나란히 두고 칸을 바꾸기 때문이다 (MAP_PRIVATE 페이지를 고쳐 쓰면 어차피 복사된다).
+bool Map::loadStageFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kStageHeaderSize)) {
+        close(fd);
+        return false;
     }
+    size_t size = st.st_size;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapped);
+    StageFileHeader header = decodeStageHeader(bytes);
+    if (!isValidStageFile(header, bytes, size)) {
+        std::cerr << "Invalid stage file: " << filename << std::endl;
+        munmap(mapped, size);
+        return false;
+    }
+
+    resize(header.height, header.width);
+    spawnY = header.spawnY;
+    spawnX = header.spawnX;
+    gatePairs = header.gatePairs;
+
+    loadGrid(reinterpret_cast<const CellType*>(bytes + header.cellsOffset), header.width + 2);
+    // 파일의 후보 칸은 행 폭 width+2 기준 인덱스라 이 맵의 인덱스로 바꾼다
+    const unsigned char* candidateBytes = bytes + header.candidatesOffset;
+    gateCandidates.resize(header.candidateCount);
+    for (uint32_t i = 0; i < header.candidateCount; ++i) {
+        uint32_t fileIdx = loadLe32(candidateBytes + i * sizeof(uint32_t));
+        gateCandidates[i] = index(fileIdx / (width + 2) - 1, fileIdx % (width + 2) - 1);
+    }
+    munmap(mapped, size);
+    dropDuplicateCandidates();
+
+    finishLoad();
+    return true;
 }
 
-void Map::clearItems() {
-    for (auto& row : mapData) {
-        for (auto& cell : row) {
-            if (cell == GROWTH_ITEM || cell == POISON_ITEM)
-                cell = EMPTY;
-        }
+void Map::loadEmbedded(const EmbeddedStage& stage) {
+    resize(stage.height, stage.width);
+    spawnY = stage.spawnY;
+    spawnX = stage.spawnX;
+    gatePairs = stage.gatePairs;
+
+    loadGrid(reinterpret_cast<const CellType*>(stage.cells), width + 2);
+    gateCandidates.clear();
+    for (int i = 0; i < stage.candidateCount; ++i)
+        gateCandidates.push_back(index(stage.candidates[i] / (width + 2) - 1,
+                                       stage.candidates[i] % (width + 2) - 1));
+    dropDuplicateCandidates();
+    finishLoad();
+}
+
+// 파일에서 읽은 게이트 후보에 같은 칸이 두 번 있으면 처음 것만 남긴다 (순서는 그대로).
+// 스테이지를 읽을 때 한 번만 하므로 pickGates는 후보가 모두 다른 칸이라고 믿는다.
+void Map::dropDuplicateCandidates() {
+    std::vector<int> sorted(gateCandidates);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end())
+        return;
+    std::unordered_set<int> seen;
+    gateCandidates.erase(std::remove_if(gateCandidates.begin(), gateCandidates.end(),
+                                        [&](int idx) { return !seen.insert(idx).second; }),
+                         gateCandidates.end());
+}
+
+// 안쪽은 비워 두고 가장자리 칸만 벽으로 채우므로 타일도 가장자리에만 잡힌다
+void Map::createArena(int h, int w) {
+    resize(h, w);
+    for (int x = 0; x < width; ++x) {
+        cells.set(index(0, x), WALL);
+        cells.set(index(height - 1, x), WALL);
+    }
+    for (int y = 0; y < height; ++y) {
+        cells.set(index(y, 0), WALL);
+        cells.set(index(y, width - 1), WALL);
     }
+    cells.set(index(0, 0), IMMUNE_WALL);
+    cells.set(index(0, width - 1), IMMUNE_WALL);
+    cells.set(index(height - 1, 0), IMMUNE_WALL);
+    cells.set(index(height - 1, width - 1), IMMUNE_WALL);
+    spawnY = height / 2;
+    spawnX = width / 2;
+    gatePairs = 1;
+    finishLoad();
+    gateCandidates = lists[LIST_WALL];
+}
+
+void Map::createEmpty(int h, int w) {
+    resize(h, w);
+    spawnY = height / 2;
+    spawnX = width / 2;
+    gatePairs = 0;
+    gateCandidates.clear();
+    finishLoad();
+}
+
+// 큰 맵(타일 격자)용 setAt/occupy 본체
+void Map::setCellSparse(int idx, int value) {
+    setCell<false>(idx, value);
 }
 
-void Map::render() {
-    for (size_t y = 0; y < mapData.size(); ++y){
-        for (size_t x = 0; x < mapData[y].size(); ++x){
-            switch(mapData[y][x]) {
-                case EMPTY:         mvprintw(y, x, " "); break;
-                case WALL:          mvprintw(y, x, "#"); break;
-                case IMMUNE_WALL:   mvprintw(y, x, "*"); break;
-                case GROWTH_ITEM:   mvprintw(y, x, "+"); break;
-                case POISON_ITEM:   mvprintw(y, x, "-"); break;
-                case GATE:	     mvprintw(y, x, "G"); break;
-                default:            mvprintw(y, x, "?"); break;
+void Map::setOwnerSparse(int idx, int owner) {
+    setOwner<false>(idx, owner);
+}
+
+// 격자, 칸 목록, 게이트 후보를 그대로 복사한다. 크기가 같으면 재할당도 없다.
+void Map::loadFrom(const Map& stage) {
+    cells = stage.cells;
+    height = stage.height;
+    width = stage.width;
+    stride = stage.stride;
+    strideShift = stage.strideShift;
+    trackFree = stage.trackFree;
+    freeCount = stage.freeCount;
+    spawnY = stage.spawnY;
+    spawnX = stage.spawnX;
+    gatePairs = stage.gatePairs;
+    gateCandidates = stage.gateCandidates;
+    occupancy = stage.occupancy;
+    for (int i = 0; i < LIST_COUNT; ++i)
+        lists[i] = stage.lists[i];
+    slot = stage.slot;
+    if (!dirtyMark.hasShapeOf(stage.dirtyMark))
+        dirtyMark.reset(height + 2, strideShift, 0, trackFree);
+    resetDirty();
+}
+
+void Map::finishLoad() {
+    occupancy.clear();
+    rebuildLists();
+    resetDirty();
+}
+
+void Map::rebuildLists() {
+    for (auto& list : lists)
+        list.clear();
+    slot.clear();
+    freeCount = 0;
+
+    if (trackFree) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int idx = index(y, x);
+                relist(idx, LIST_NONE, listOf(idx));
             }
         }
+        return;
+    }
+
+    // 큰 맵: 할당되지 않은 타일은 전부 빈 칸이므로 할당된 타일에서 빈 칸이 아닌 칸만 센다
+    freeCount = long(height) * width;
+    int tileRows = cells.getTileRows(), tileCols = cells.getTileCols();
+    cells.forEachTile([&](int row0, int col0) {
+        for (int row = row0; row < row0 + tileRows; ++row) {
+            for (int col = col0; col < col0 + tileCols; ++col) {
+                int y = row - 1, x = col - 1;
+                if (y < 0 || y >= height || x < 0 || x >= width) continue;
+                int idx = index(y, x);
+                int list = listOf(idx);
+                if (list == LIST_FREE) continue;
+                --freeCount;
+                relist(idx, LIST_NONE, list);
+            }
+        }
+    });
+}
+
+void Map::resetDirty() {
+    dirtyCells.clear();
+    dirtyMark.clear();
+    ++loadCount;
+    ++layoutVersion;
+}
+
+void Map::clearDirty() {
+    for (int idx : dirtyCells)
+        dirtyMark.set(idx, 0);
+    dirtyCells.clear();
+}
+
+int Map::randomFreeCell(Rng& rng) const {
+    if (trackFree) {
+        const std::vector<int>& freeCells = lists[LIST_FREE];
+        if (freeCells.empty()) return -1;
+        return freeCells[rng.below(freeCells.size())];
+    }
+
+    // 큰 맵은 거의 비어 있으므로 무작위 칸을 몇 번 뽑아 보면 충분하다
+    if (freeCount == 0) return -1;
+    for (int i = 0; i < kFreeCellTries; ++i) {
+        int idx = index(rng.below(height), rng.below(width));
+        if (listOf(idx) == LIST_FREE) return idx;
+    }
+    // 거의 찬 경우에만: 무작위 행부터 훑어서 처음 나오는 빈 칸 (균등하지는 않다)
+    int startY = rng.below(height);
+    for (int i = 0; i < height; ++i) {
+        int y = (startY + i) % height;
+        for (int x = 0; x < width; ++x) {
+            if (listOf(index(y, x)) == LIST_FREE) return index(y, x);
+        }
     }
-    refresh();
+    return -1;
+}
+
+
+void Map::addItem(int type, Rng& rng) {
+    int idx = randomFreeCell(rng);
+    if (idx >= 0)
+        setAt(idx, type);
+}
+
+void Map::clearItems() {
+    clearItem(GROWTH_ITEM);
+    clearItem(POISON_ITEM);
 }
 
 int Map::getValue(int y, int x) const {
-    if (y < 0 || static_cast<size_t>(y) >= mapData.size()) return -1;
-    if (x < 0 || static_cast<size_t>(x) >= mapData[y].size()) return -1;
-    return mapData[y][x];
+    // 센티넬 테두리까지는 읽을 수 있다 (WALL)
+    if (static_cast<unsigned>(y + 1) >= static_cast<unsigned>(height + 2)) return -1;
+    if (static_cast<unsigned>(x + 1) >= static_cast<unsigned>(width + 2)) return -1;
+    return cells.get(index(y, x));
 }
 
 void Map::setValue(int y, int x, int value) {
-    if (y < 0 || static_cast<size_t>(y) >= mapData.size()) return;
-    if (x < 0 || static_cast<size_t>(x) >= mapData[y].size()) return;
-    mapData[y][x] = value;
+    if (static_cast<unsigned>(y) >= static_cast<unsigned>(height)) return;
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(width)) return;
+    setAt(index(y, x), value);
 }
-std::vector<std::pair<int, int>> Map::getWallPositions() const {
-    std::vector<std::pair<int, int>> walls;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (mapData[y][x] == 1) {
-                walls.emplace_back(y, x);
+void Map::getFilledCells(std::vector<int>& out) const {
+    out.clear();
+    int tileRows = cells.getTileRows(), tileCols = cells.getTileCols();
+    cells.forEachTile([&](int row0, int col0) {
+        for (int row = row0; row < row0 + tileRows; ++row) {
+            for (int col = col0; col < col0 + tileCols; ++col) {
+                int y = row - 1, x = col - 1;
+                if (y < 0 || y >= height || x < 0 || x >= width) continue;
+                int idx = index(y, x);
+                if (cells.get(idx) != EMPTY)
+                    out.push_back(idx);
             }
         }
-    }
+    });
+}
+
+std::vector<std::pair<int, int>> Map::getWallPositions() const {
+    std::vector<std::pair<int, int>> walls;
+    walls.reserve(lists[LIST_WALL].size());
+    for (int idx : lists[LIST_WALL])
+        walls.emplace_back(rowOf(idx), colOf(idx));
     return walls;
 }
 void Map::clearItem(int itemType) {
-    for (auto& row : mapData) {
-        for (auto& cell : row) {
-            if (cell == itemType) {
-                cell = EMPTY;
-            }
-        }
-    }
+    std::vector<int>* items;
+    if (itemType == GROWTH_ITEM)
+        items = &lists[LIST_GROWTH];
+    else if (itemType == POISON_ITEM)
+        items = &lists[LIST_POISON];
+    else
+        return;
+
+    // setAt이 목록에서 지우므로 뒤에서부터 비운다
+    while (!items->empty())
+        setAt(items->back(), EMPTY);
 }
-// Map.cpp
+
+// 뱀이 차지한 칸은 빈 칸으로 치지 않는다
 std::vector<std::pair<int,int>> Map::getEmptyPositions() const {
     std::vector<std::pair<int,int>> empties;
+    empties.reserve(getFreeCount());
+    if (trackFree) {
+        for (int idx : lists[LIST_FREE])
+            empties.emplace_back(rowOf(idx), colOf(idx));
+        return empties;
+    }
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
-            if (mapData[y][x] == EMPTY) {
+            if (listOf(index(y, x)) == LIST_FREE)
                 empties.emplace_back(y, x);
-            }
         }
     }
     return empties;
 }
 
-
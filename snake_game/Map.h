@@ -1,6 +1,10 @@
 #pragma once
+#include <cstddef>
+#include <string>
 #include <vector>
-enum CellType {
+#include "ChunkedGrid.h"
+#include "Rng.h"
+enum CellType : unsigned char {
     EMPTY = 0,
     WALL = 1,
     IMMUNE_WALL = 2,
@@ -11,24 +15,187 @@ enum CellType {
     GATE = 7
 };
 
+// Map이 위치를 따로 관리하는 칸 종류
+enum CellList {
+    LIST_NONE = -1,
+    LIST_FREE = 0,   // EMPTY이고 뱀이 없는 칸
+    LIST_WALL,
+    LIST_GROWTH,
+    LIST_POISON,
+    LIST_GATE,
+    LIST_COUNT
+};
+
+struct EmbeddedStage;
+
 class Map {
 private:
-    std::vector<std::vector<int>> mapData;
-    int height, width;
+    // (height+2)행, 행 폭 stride의 1바이트 격자. stride는 width+2 이상인 2의 거듭제곱이다.
+    // 바깥 테두리 한 칸은 WALL 센티넬이라 이웃 칸 접근에 경계 검사가 필요 없다.
+    // 큰 맵은 4096칸 타일 단위로 빈 칸이 아닌 곳만 메모리를 잡으므로 빈 경기장은 테두리만큼만 든다.
+    ChunkedGrid<CellType> cells;
+    int height = 0, width = 0;
+    int stride = 0;
+    int strideShift = 0;
+    int spawnY = 0, spawnX = 0;  // 뱀 머리 시작 위치 (오른쪽을 보고 시작)
+    int gatePairs = 1;
+    std::vector<int> gateCandidates;  // 게이트를 놓을 수 있는 칸
+    // 뱀 몸통 점유 표시 (cells와 같은 인덱스). 뱀이 머리/꼬리를 옮길 때 갱신한다.
+    // 0이면 빈 칸이고, 아니면 그 칸을 차지한 뱀의 번호 + 1이다 (여러 뱀이 한 격자를 같이 쓴다).
+    ChunkedGrid<unsigned char> occupancy;
+
+    // 칸 종류별 위치 목록 (빈 칸, 벽, 아이템, 게이트). 한 칸은 최대 한 목록에만 들어가므로
+    // slot[idx] 하나로 그 목록 안의 위치를 기록한다 (없으면 -1).
+    // 삭제는 마지막 원소와 자리를 바꿔서 O(1)에 처리한다.
+    // 안쪽 칸이 kFreeListLimit보다 많은 맵은 빈 칸 목록 대신 개수(freeCount)만 센다.
+    std::vector<int> lists[LIST_COUNT];
+    ChunkedGrid<int> slot;
+    bool trackFree = true;  // 격자 넷이 모두 dense인 맵이기도 하다
+    long freeCount = 0;
+
+    // 마지막 clearDirty() 이후 값이나 점유가 바뀐 칸 (화면을 부분적으로 다시 그릴 때 쓴다)
+    std::vector<int> dirtyCells;
+    ChunkedGrid<unsigned char> dirtyMark;
+    unsigned loadCount = 0;  // 맵을 새로 불러올 때마다 증가
+    unsigned layoutVersion = 0;  // 통행 가능한 칸 배치가 바뀔 때마다 증가 (게이트 출구 표 무효화)
+
+    void resize(int h, int w);
+    void loadGrid(const CellType* grid, int gridStride);
+    void finishLoad();
+    void dropDuplicateCandidates();
+    void rebuildLists();
+    void resetDirty();
+    // Dense = true는 trackFree인 맵(모든 격자가 dense)에서만 쓴다. 격자마다 dense인지 묻지 않는다.
+    template <bool Dense = false>
+    void markDirty(int idx) {
+        if (dirtyMark.read<Dense>(idx)) return;
+        dirtyMark.write<Dense>(idx, 1);
+        dirtyCells.push_back(idx);
+    }
+    template <bool Dense = false>
+    int listOf(int idx) const {
+        static const signed char kListOfCell[8] = {
+            LIST_FREE, LIST_WALL, LIST_NONE, LIST_NONE,
+            LIST_NONE, LIST_GROWTH, LIST_POISON, LIST_GATE
+        };
+        int list = kListOfCell[cells.read<Dense>(idx) & 7];
+        return (list == LIST_FREE && occupancy.read<Dense>(idx)) ? LIST_NONE : list;
+    }
+    template <bool Dense = false>
+    void relist(int idx, int from, int to) {
+        if (from == to) return;
+        if (!Dense && from == LIST_FREE && !trackFree) {
+            --freeCount;
+        } else if (from != LIST_NONE) {
+            std::vector<int>& list = lists[from];
+            int last = list.back();
+            int pos = slot.read<Dense>(idx);
+            list[pos] = last;
+            slot.write<Dense>(last, pos);
+            list.pop_back();
+            slot.write<Dense>(idx, -1);
+        }
+        if (!Dense && to == LIST_FREE && !trackFree) {
+            ++freeCount;
+        } else if (to != LIST_NONE) {
+            slot.write<Dense>(idx, lists[to].size());
+            lists[to].push_back(idx);
+        }
+    }
+
+    // setAt/occupy/vacate 본체. 작은 맵은 분기 없는 Dense 판을 인라인하고,
+    // 큰 맵 판(타일 할당 호출이 들어 있다)은 Map.cpp에 따로 두어 작은 맵 경로를 키우지 않는다.
+    template <bool Dense>
+    void setCell(int idx, int value) {
+        int from = listOf<Dense>(idx);
+        if (isPassable(cells.read<Dense>(idx)) != isPassable(value))
+            ++layoutVersion;
+        cells.write<Dense>(idx, static_cast<CellType>(value));
+        relist<Dense>(idx, from, listOf<Dense>(idx));
+        markDirty<Dense>(idx);
+    }
+    template <bool Dense>
+    void setOwner(int idx, int owner) {
+        int from = listOf<Dense>(idx);
+        occupancy.write<Dense>(idx, static_cast<unsigned char>(owner));
+        relist<Dense>(idx, from, listOf<Dense>(idx));
+        markDirty<Dense>(idx);
+    }
+    void setCellSparse(int idx, int value);
+    void setOwnerSparse(int idx, int owner);
 
 public:
     void setValue(int y, int x, int value);
     void loadStage(int stage);
-    void render();
+    bool loadStageText(const std::string& filename);
+    bool loadStageFile(const std::string& filename);  // 바이너리 (.stg)
+    void createArena(int h, int w); // 테두리만 벽인 빈 맵
+    void createEmpty(int h, int w); // 안쪽이 모두 빈 칸인 맵 (원격 화면이 받은 칸을 채워 넣는다)
+    void loadFrom(const Map& stage);  // 미리 불러 둔 스테이지를 복사 (파일을 다시 읽지 않는다)
+    void loadEmbedded(const EmbeddedStage& stage);  // 실행 파일에 내장된 스테이지
     int getValue(int y, int x) const;
 
-    void addItem(int type); // type: 3(GROWTH), 4(POISON)
+    void addItem(int type, Rng& rng); // type: GROWTH_ITEM, POISON_ITEM
     void clearItems();      // 아이템 제거
     std::vector<std::pair<int, int>> getWallPositions() const;
     void clearItem(int itemType);
     std::vector<std::pair<int,int>> getEmptyPositions() const;
+    // EMPTY가 아닌 안쪽 칸을 out에 채운다 (큰 맵은 할당된 타일만 본다)
+    void getFilledCells(std::vector<int>& out) const;
     int getWidth() const {return width; }
     int getHeight() const { return height; }
+    int getSpawnY() const { return spawnY; }
+    int getSpawnX() const { return spawnX; }
+    void setSpawn(int y, int x) { spawnY = y; spawnX = x; }
+    int getGatePairs() const { return gatePairs; }
+    void setGatePairs(int pairs) { gatePairs = pairs; }
+    const std::vector<int>& getGateCandidates() const { return gateCandidates; }
 
-};
+    // 셀 인덱스가 int에 들어가는 크기인지 (맵을 만들기 전에 확인한다)
+    static bool fitsIndex(long h, long w);
 
+    // 셀 인덱스 기반 접근 (경계 검사 없음)
+    int index(int y, int x) const { return ((y + 1) << strideShift) + (x + 1); }
+    int rowOf(int idx) const { return (idx >> strideShift) - 1; }
+    int colOf(int idx) const { return (idx & (stride - 1)) - 1; }
+    int getStride() const { return stride; }
+    CellType at(int idx) const { return cells.get(idx); }
+    int getCellCount() const { return (height + 2) * stride; }
+    std::size_t getAllocatedCells() const { return cells.getAllocatedCells(); }  // 메모리를 잡은 칸 수
+    void setAt(int idx, int value) {
+        if (trackFree)
+            setCell<true>(idx, value);
+        else
+            setCellSparse(idx, value);
+    }
+
+    static const int kMaxOwners = 255;  // 점유 표시 한 칸에 담을 수 있는 뱀 수
+
+    bool isOccupied(int idx) const { return occupancy.get(idx) != 0; }
+    int ownerAt(int idx) const { return occupancy.get(idx); }  // 차지한 뱀 번호 + 1 (없으면 0)
+    void occupy(int idx, int owner = 1) {
+        if (trackFree)
+            setOwner<true>(idx, owner);
+        else
+            setOwnerSparse(idx, owner);
+    }
+    void vacate(int idx) { occupy(idx, 0); }
+
+    // 뱀 머리가 들어갈 수 있는 칸 (빈 칸, 아이템). 점유 여부는 따로 본다.
+    static bool isPassable(int value) {
+        return value == EMPTY || value == GROWTH_ITEM || value == POISON_ITEM;
+    }
+    unsigned getLayoutVersion() const { return layoutVersion; }
+
+    // 종류별 셀 인덱스 목록 (순서는 보장하지 않음). 큰 맵에서는 LIST_FREE가 비어 있다.
+    const std::vector<int>& cellsOf(CellList list) const { return lists[list]; }
+
+    // 빈 칸 하나를 균등하게 뽑는다. 빈 칸이 없으면 -1.
+    int randomFreeCell(Rng& rng) const;
+    long getFreeCount() const { return trackFree ? long(lists[LIST_FREE].size()) : freeCount; }
+
+    const std::vector<int>& getDirtyCells() const { return dirtyCells; }
+    void clearDirty();
+    unsigned getLoadCount() const { return loadCount; }
+
+};
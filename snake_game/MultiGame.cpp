@@ -0,0 +1,221 @@
+#include "MultiGame.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const int kSpawnTries = 1000;  // 시작 자리를 무작위로 찾아보는 횟수
+
+// 아이템도 뱀도 없는 빈 칸
+bool isOpen(const Map& map, int idx) {
+    return map.at(idx) == EMPTY && !map.isOccupied(idx);
+}
+
+} // namespace
+
+MultiGame::MultiGame(const MultiConfig& config, std::shared_ptr<const StageCache> stages)
+    : config(config), stages(std::move(stages)) {
+    this->config.snakeCount = std::max(1, std::min(config.snakeCount, int(Map::kMaxOwners)));
+    if (!this->stages)
+        this->stages = std::make_shared<const StageCache>(1, config.arenaHeight, config.arenaWidth);
+    if (int failed = this->stages->getFailedStage())
+        throw std::runtime_error("failed to load stage " + std::to_string(failed));
+
+    int count = this->config.snakeCount;
+    players.resize(count);
+    plans.resize(count);
+    movers.reserve(count);
+    dying.reserve(count);
+
+    // 뱀 수의 두 배 이상인 2의 거듭제곱 크기 (반 이상 비어 있어서 탐색이 짧다)
+    unsigned slots = 2;
+    claimShift = 31;
+    while (slots < 2u * count) {
+        slots <<= 1;
+        --claimShift;
+    }
+    claimKeys.assign(slots, -1);
+    claimCounts.assign(slots, 0);
+    claimUsed.reserve(count);
+    claimMask = slots - 1;
+}
+
+void MultiGame::reset(uint64_t seed) {
+    rng.seed(seed);
+    tick = 0;
+    lastGrowthItemTick = 0;
+    lastPoisonItemTick = 0;
+    aliveCount = 0;
+    map.loadFrom(stages->getStage(1));
+
+    for (int id = 0; id < config.snakeCount; ++id)
+        spawn(id);
+
+    map.clearItems();
+    for (int i = 0; i < itemsPerKind(); ++i) {
+        map.addItem(GROWTH_ITEM, rng);
+        map.addItem(POISON_ITEM, rng);
+    }
+
+    std::vector<int> gateCells;
+    GateTable::pickGates(map.getGateCandidates(), map.getGatePairs(), rng, gateCells);
+    for (int idx : gateCells)
+        map.setAt(idx, GATE);
+    gates.build(map, gateCells);
+}
+
+// 0번 뱀은 맵의 시작 위치, 나머지는 오른쪽을 보고 세 칸이 들어가는 무작위 빈 자리
+void MultiGame::spawn(int id) {
+    Player& player = players[id];
+    player.death = DEATH_NONE;
+    player.killer = -1;
+    player.deathTick = -1;
+    player.growthCount = player.poisonCount = player.gateUseCount = 0;
+
+    int y = map.getSpawnY(), x = map.getSpawnX();
+    if (id > 0) {
+        bool found = false;
+        for (int i = 0; i < kSpawnTries && !found; ++i) {
+            int idx = map.randomFreeCell(rng);
+            if (idx < 0) break;
+            y = map.rowOf(idx);
+            x = map.colOf(idx);
+            found = x >= 2 && isOpen(map, idx - 1) && isOpen(map, idx - 2) &&
+                    !Snake::isBlocked(map, idx + 1);
+        }
+        if (!found) {
+            player.death = DEATH_NO_ROOM;
+            player.deathTick = 0;
+            return;
+        }
+    }
+    player.snake.init(map, y, x, id + 1);
+    ++aliveCount;
+}
+
+int MultiGame::itemsPerKind() const {
+    if (config.itemsPerKind > 0) return config.itemsPerKind;
+    return std::max(1, config.snakeCount / 4);
+}
+
+int MultiGame::step(const Direction* actions) {
+    movers.clear();
+    dying.clear();
+
+    // 1, 2. 방향을 바꾸고 들어갈 칸을 정한다. 틱 시작 때의 맵으로만 판정한다.
+    for (int id = 0; id < config.snakeCount; ++id) {
+        Player& player = players[id];
+        if (!player.isAlive()) continue;
+        Snake& snake = player.snake;
+
+        if (actions[id] != snake.getDirection() && !snake.updateDirection(actions[id])) {
+            kill(id, DEATH_REVERSE);
+            continue;
+        }
+
+        const Snake::Plan& plan = plans[id] = snake.planMove(map, gates);
+        if (plan.deadEnd || Snake::isBlocked(map, plan.cell)) {
+            int owner = map.ownerAt(plan.cell);
+            if (owner == 0)
+                kill(id, DEATH_WALL);
+            else if (owner == id + 1)
+                kill(id, DEATH_SELF);
+            else
+                kill(id, DEATH_BODY, owner - 1);
+            continue;
+        }
+        movers.push_back(id);
+        ++claimCounts[claim(plan.cell)];
+    }
+
+    // 3. 같은 칸을 노린 뱀은 모두 죽는다
+    std::size_t kept = 0;
+    for (int id : movers) {
+        if (claimCounts[claim(plans[id].cell)] > 1)
+            kill(id, DEATH_HEAD_ON);
+        else
+            movers[kept++] = id;
+    }
+    movers.resize(kept);
+    for (unsigned s : claimUsed)
+        claimKeys[s] = -1;
+    claimUsed.clear();
+
+    // 4. 옮긴다
+    int eatenGrowth = 0, eatenPoison = 0;
+    for (int id : movers) {
+        Player& player = players[id];
+        switch (player.snake.applyMove(map, plans[id])) {
+            case Snake::MOVE_GROWTH:
+                ++player.growthCount;
+                ++eatenGrowth;
+                break;
+            case Snake::MOVE_POISON:
+                ++player.poisonCount;
+                ++eatenPoison;
+                break;
+            case Snake::MOVE_GATE:
+                ++player.gateUseCount;
+                break;
+            case Snake::MOVE_DEAD:
+                // 독을 먹고 길이가 모자라졌다 (독은 이미 먹혔다)
+                ++player.poisonCount;
+                ++eatenPoison;
+                kill(id, DEATH_POISON);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 5. 죽은 뱀을 치우고 먹힌 아이템을 다시 놓는다
+    for (int id : dying)
+        players[id].snake.clear(map);
+    for (int i = 0; i < eatenGrowth; ++i) {
+        map.addItem(GROWTH_ITEM, rng);
+        lastGrowthItemTick = tick;
+    }
+    for (int i = 0; i < eatenPoison; ++i) {
+        map.addItem(POISON_ITEM, rng);
+        lastPoisonItemTick = tick;
+    }
+
+    ++tick;
+    refreshItems(GROWTH_ITEM, lastGrowthItemTick);
+    refreshItems(POISON_ITEM, lastPoisonItemTick);
+    return dying.size();
+}
+
+void MultiGame::kill(int id, DeathCause cause, int killer) {
+    Player& player = players[id];
+    player.death = cause;
+    player.killer = killer;
+    player.deathTick = tick;
+    dying.push_back(id);
+    --aliveCount;
+}
+
+// cell의 슬롯 (없으면 새로 잡는다). 슬롯이 뱀 수의 두 배 이상이라 항상 빈 슬롯이 있다.
+unsigned MultiGame::claim(int cell) {
+    unsigned s = (unsigned(cell) * 0x9E3779B1u) >> claimShift;
+    while (claimKeys[s] != cell) {
+        if (claimKeys[s] < 0) {
+            claimKeys[s] = cell;
+            claimCounts[s] = 0;
+            claimUsed.push_back(s);
+            break;
+        }
+        s = (s + 1) & claimMask;
+    }
+    return s;
+}
+
+// 일정 시간 아무도 먹지 않은 종류의 아이템은 모두 다른 자리로 옮긴다
+void MultiGame::refreshItems(int itemType, long& lastTick) {
+    if (tick - lastTick < config.itemLifetimeTicks) return;
+    map.clearItem(itemType);
+    for (int i = 0; i < itemsPerKind(); ++i)
+        map.addItem(itemType, rng);
+    lastTick = tick;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GateTable.h"
+#include "Map.h"
+#include "Rng.h"
+#include "Snake.h"
+#include "StageCache.h"
+
+// 한 맵에서 뱀 여러 마리(사람/봇)가 같이 움직이는 규칙 엔진. 미션과 스테이지 전환은 없다.
+// 모든 몸통은 Map의 점유 표시에 (뱀 번호 + 1)로 들어가므로 머리-몸통 충돌은 칸 하나만 보면 되고,
+// 머리끼리 같은 칸을 노리는 경우는 틱마다 비우는 작은 해시로 찾는다. 뱀끼리 몸통을 훑지 않는다.
+//
+// 한 틱은 모두 동시에 움직인 것으로 본다.
+//   1. 살아 있는 뱀마다 방향을 바꾸고 머리가 들어갈 칸을 정한다 (맵은 그대로).
+//   2. 틱 시작 때의 맵에서 벽이나 몸통(꼬리 포함)인 칸으로 가는 뱀은 죽는다.
+//   3. 남은 뱀 중 같은 칸을 노린 뱀은 모두 죽는다.
+//   4. 남은 뱀을 번호 순서로 옮긴다. 노린 칸이 모두 다르고 비어 있었으므로 순서는 결과에 영향이 없다.
+//   5. 죽은 뱀의 몸통을 지우고, 먹힌 아이템을 번호 순서로 다시 놓는다.
+// 같은 시드와 같은 입력이면 항상 같은 결과가 나온다.
+
+struct MultiConfig {
+    int snakeCount = 2;          // 최대 Map::kMaxOwners
+    int itemLifetimeTicks = 67;
+    int itemsPerKind = 0;        // 성장/독 아이템을 각각 몇 개 둘지 (0이면 뱀 4마리당 하나, 최소 하나)
+    int arenaHeight = 0;         // 0보다 크면 stage 1 대신 이 크기의 빈 경기장
+    int arenaWidth = 0;
+};
+
+class MultiGame {
+public:
+    enum DeathCause {
+        DEATH_NONE = 0,
+        DEATH_WALL,      // 벽
+        DEATH_SELF,      // 자기 몸통
+        DEATH_BODY,      // 다른 뱀의 몸통 (killer가 그 뱀)
+        DEATH_HEAD_ON,   // 다른 뱀과 같은 칸으로 들어감
+        DEATH_POISON,    // 독으로 길이 부족
+        DEATH_REVERSE,   // 진행 방향의 반대로 입력
+        DEATH_NO_ROOM,   // 시작할 자리가 없었다
+        DEATH_COUNT
+    };
+
+    struct Player {
+        Snake snake;
+        DeathCause death = DEATH_NONE;
+        int killer = -1;       // DEATH_BODY일 때 부딪힌 몸통의 뱀 번호
+        long deathTick = -1;
+        int growthCount = 0;
+        int poisonCount = 0;
+        int gateUseCount = 0;
+        bool isAlive() const { return death == DEATH_NONE; }
+    };
+
+    explicit MultiGame(const MultiConfig& config = MultiConfig(),
+                       std::shared_ptr<const StageCache> stages = nullptr);
+
+    void reset(uint64_t seed);
+    // 한 틱 진행. actions[i]는 i번 뱀의 입력 (죽은 뱀은 무시). 이번 틱에 죽은 뱀 수를 돌려준다.
+    int step(const Direction* actions);
+
+    // 살아 있는 뱀이 하나 이하면 끝 (혼자 하는 경기는 죽으면 끝)
+    bool isOver() const { return aliveCount <= (config.snakeCount > 1 ? 1 : 0); }
+    void markRendered() { map.clearDirty(); }
+
+    const Map& getMap() const { return map; }
+    const MultiConfig& getConfig() const { return config; }
+    int getSnakeCount() const { return config.snakeCount; }
+    const Player& getPlayer(int id) const { return players[id]; }
+    int getAliveCount() const { return aliveCount; }
+    long getTick() const { return tick; }
+
+private:
+    MultiConfig config;
+    std::shared_ptr<const StageCache> stages;
+    Map map;
+    Rng rng;
+    GateTable gates;  // 모든 뱀이 같이 쓰는 출구 표
+    std::vector<Player> players;
+    std::vector<Snake::Plan> plans;
+    std::vector<int> movers;   // 이번 틱에 움직이는 뱀 번호 (번호 순서)
+    std::vector<int> dying;    // 이번 틱에 죽은 뱀 번호
+    int aliveCount = 0;
+    long tick = 0;
+    long lastGrowthItemTick = 0;
+    long lastPoisonItemTick = 0;
+
+    // 머리가 들어갈 칸 -> 그 칸을 노린 뱀 수 (오픈 어드레싱). 틱마다 쓴 슬롯만 비운다.
+    std::vector<int> claimKeys;    // 셀 인덱스 (-1이면 빈 슬롯)
+    std::vector<int> claimCounts;
+    std::vector<unsigned> claimUsed;
+    unsigned claimMask = 0;
+    int claimShift = 32;
+
+    int itemsPerKind() const;
+    void spawn(int id);
+    void kill(int id, DeathCause cause, int killer = -1);
+    unsigned claim(int cell);
+    void refreshItems(int itemType, long& lastTick);
+};
@@ -0,0 +1,22 @@
+#include "NcursesCanvas.h"
+#include <ncurses.h>
+
+void NcursesCanvas::put(int y, int x, const char* text) {
+    mvaddstr(y, x, text);
+}
+
+void NcursesCanvas::clear() {
+    ::clear();
+}
+
+void NcursesCanvas::flush() {
+    refresh();
+}
+
+int NcursesCanvas::getRows() const {
+    return LINES;
+}
+
+int NcursesCanvas::getCols() const {
+    return COLS;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "Canvas.h"
+
+// stdscr에 그리는 Canvas
+class NcursesCanvas : public Canvas {
+public:
+    void put(int y, int x, const char* text) override;
+    void clear() override;
+    void flush() override;
+    int getRows() const override;
+    int getCols() const override;
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 게임 서버와 터미널 클라이언트 사이의 메시지 형식.
+// 메시지 하나는 [종류 1바이트][본문 길이 4바이트][본문]이고 정수는 모두 리틀 엔디언이다.
+// 칸 위치는 맵 행 폭(stride)과 상관없이 y * width + x로 보낸다.
+//
+// 서버 -> 클라이언트
+//   WELCOME   버전 u8, 내 뱀 번호 u8 (kSpectator면 구경만), 뱀 수 u8, 높이 u32, 너비 u32
+//   SNAPSHOT  틱 u32, 칸 수 u32, 칸 {위치 u32, 값 u8, 주인 u8}..., 뱀 수 u8, 뱀 기록...
+//             (받으면 맵을 비우고 다시 채운다. 판이 새로 시작할 때와 접속했을 때)
+//   TICK      틱 u32, 칸 수 u32, 칸..., 뱀 수 u8, 뱀 기록...
+//             (직전 메시지 이후 바뀐 칸과 바뀐 뱀만)
+// 뱀 기록은 {번호 u8, 머리 위치 u32 (죽었으면 kNoCell), 길이 u32, +, -, G 각 u16, 죽은 이유 u8}.
+//
+// 클라이언트 -> 서버: 방향 하나가 바이트 하나 (Direction 값 0~3). 다른 바이트는 무시한다.
+
+const int kProtocolVersion = 1;
+const unsigned kSpectator = 255;
+const uint32_t kNoCell = 0xFFFFFFFFu;
+const std::size_t kFrameHeader = 5;
+
+enum MessageType : unsigned char {
+    MSG_WELCOME = 1,
+    MSG_SNAPSHOT = 2,
+    MSG_TICK = 3
+};
+
+// 클라이언트 화면에 필요한 뱀 하나의 상태 (서버는 지난번에 보낸 값과 비교해서 바뀐 것만 보낸다)
+struct SnakeRecord {
+    uint32_t head = kNoCell;
+    uint32_t length = 0;
+    uint16_t growth = 0, poison = 0, gates = 0;
+    uint8_t death = 0;  // MultiGame::DeathCause
+
+    bool operator==(const SnakeRecord& other) const {
+        return head == other.head && length == other.length && growth == other.growth &&
+               poison == other.poison && gates == other.gates && death == other.death;
+    }
+    bool operator!=(const SnakeRecord& other) const { return !(*this == other); }
+};
+
+// 메시지를 바이트 버퍼 하나에 이어 붙인다. begin/end 사이에 본문을 쓴다.
+class MessageWriter {
+public:
+    void clear() { bytes.clear(); }
+    const unsigned char* data() const { return bytes.data(); }
+    std::size_t size() const { return bytes.size(); }
+
+    void begin(MessageType type) {
+        start = bytes.size();
+        u8(type);
+        u32(0);
+    }
+    void end() { patch(start + 1, bytes.size() - start - kFrameHeader); }
+
+    void u8(unsigned value) { bytes.push_back(static_cast<unsigned char>(value)); }
+    void u16(unsigned value) {
+        u8(value & 0xFF);
+        u8((value >> 8) & 0xFF);
+    }
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) u8((value >> (8 * i)) & 0xFF);
+    }
+    // 나중에 채울 u32 자리 (개수를 다 센 뒤에 patch로 쓴다)
+    std::size_t reserve32() {
+        u32(0);
+        return bytes.size() - 4;
+    }
+    void patch(std::size_t pos, uint32_t value) {
+        for (int i = 0; i < 4; ++i) bytes[pos + i] = (value >> (8 * i)) & 0xFF;
+    }
+    void patch8(std::size_t pos, unsigned value) { bytes[pos] = static_cast<unsigned char>(value); }
+
+    void record(unsigned id, const SnakeRecord& r) {
+        u8(id);
+        u32(r.head);
+        u32(r.length);
+        u16(r.growth);
+        u16(r.poison);
+        u16(r.gates);
+        u8(r.death);
+    }
+
+private:
+    std::vector<unsigned char> bytes;
+    std::size_t start = 0;
+};
+
+// 메시지 본문 하나를 읽는다. 본문보다 많이 읽으면 ok()가 false가 되고 0을 돌려준다.
+class MessageReader {
+public:
+    MessageReader(const unsigned char* data, std::size_t size) : p(data), endp(data + size) {}
+
+    bool ok() const { return good; }
+    std::size_t remaining() const { return endp - p; }
+
+    unsigned u8() { return take(1) ? p[-1] : 0; }
+    unsigned u16() { return take(2) ? p[-2] | (p[-1] << 8) : 0; }
+    uint32_t u32() {
+        if (!take(4)) return 0;
+        return uint32_t(p[-4]) | uint32_t(p[-3]) << 8 | uint32_t(p[-2]) << 16 | uint32_t(p[-1]) << 24;
+    }
+
+    void record(unsigned& id, SnakeRecord& r) {
+        id = u8();
+        r.head = u32();
+        r.length = u32();
+        r.growth = u16();
+        r.poison = u16();
+        r.gates = u16();
+        r.death = u8();
+    }
+
+    // data에 메시지 하나가 다 들어와 있으면 그 길이(머리 포함), 아니면 0
+    static std::size_t frameSize(const unsigned char* data, std::size_t size) {
+        if (size < kFrameHeader) return 0;
+        MessageReader header(data + 1, 4);
+        std::size_t total = kFrameHeader + header.u32();
+        return size >= total ? total : 0;
+    }
+
+private:
+    const unsigned char* p;
+    const unsigned char* endp;
+    bool good = true;
+
+    bool take(std::size_t n) {
+        if (!good || std::size_t(endp - p) < n) {
+            good = false;
+            return false;
+        }
+        p += n;
+        return true;
+    }
+};
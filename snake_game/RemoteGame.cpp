@@ -0,0 +1,72 @@
+#include "RemoteGame.h"
+
+bool RemoteGame::apply(unsigned char type, MessageReader& reader) {
+    switch (type) {
+        case MSG_WELCOME: {
+            if (reader.u8() != unsigned(kProtocolVersion)) return false;
+            player = reader.u8();
+            unsigned count = reader.u8();
+            height = reader.u32();
+            width = reader.u32();
+            if (!reader.ok() || !Map::fitsIndex(height, width)) return false;
+            snakes.assign(count, SnakeRecord());
+            heads.assign(count, -1);
+            joined = true;
+            return true;
+        }
+        case MSG_SNAPSHOT:
+            if (!joined) return false;
+            map.createEmpty(height, width);
+            ++snapshots;
+            tick = reader.u32();
+            return applyCells(reader) && applySnakes(reader);
+        case MSG_TICK:
+            if (!joined) return false;
+            tick = reader.u32();
+            return applyCells(reader) && applySnakes(reader);
+        default:
+            return false;
+    }
+}
+
+bool RemoteGame::applyCells(MessageReader& reader) {
+    uint32_t count = reader.u32();
+    uint32_t area = uint32_t(height) * width;
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        uint32_t cell = reader.u32();
+        unsigned value = reader.u8();
+        unsigned owner = reader.u8();
+        if (cell >= area || value > GATE || owner > snakes.size()) return false;
+        int idx = map.index(cell / width, cell % width);
+        if (map.at(idx) != value)
+            map.setAt(idx, value);
+        if (map.ownerAt(idx) != int(owner)) {
+            if (owner)
+                map.occupy(idx, owner);
+            else
+                map.vacate(idx);
+        }
+    }
+    return reader.ok();
+}
+
+bool RemoteGame::applySnakes(MessageReader& reader) {
+    unsigned count = reader.u8();
+    uint32_t area = uint32_t(height) * width;
+    for (unsigned i = 0; i < count && reader.ok(); ++i) {
+        unsigned id;
+        SnakeRecord r;
+        reader.record(id, r);
+        if (id >= snakes.size() || (r.head != kNoCell && r.head >= area)) return false;
+        snakes[id] = r;
+        heads[id] = r.head == kNoCell ? -1 : map.index(r.head / width, r.head % width);
+    }
+    return reader.ok();
+}
+
+int RemoteGame::getAliveCount() const {
+    int alive = 0;
+    for (const SnakeRecord& r : snakes)
+        if (r.death == 0) ++alive;
+    return alive;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include "Map.h"
+#include "Protocol.h"
+
+// 클라이언트 쪽: 서버가 보낸 메시지를 적용해서 맵과 뱀 상태를 그대로 따라간다.
+// 맵은 Map 하나에 받은 칸을 써 넣으므로 변경 칸 목록이 쌓이고, Renderer가 그 칸만 다시 그린다.
+class RemoteGame {
+public:
+    // 메시지 하나를 적용한다. 모르는 종류거나 본문이 깨졌으면 false
+    bool apply(unsigned char type, MessageReader& reader);
+
+    bool isJoined() const { return joined; }
+    int getPlayer() const { return player == kSpectator ? -1 : int(player); }  // 구경만 하면 -1
+    int getSnakeCount() const { return int(snakes.size()); }
+    long getTick() const { return tick; }
+    unsigned getSnapshotCount() const { return snapshots; }
+    int getAliveCount() const;
+    const SnakeRecord& getSnake(int id) const { return snakes[id]; }
+    // 뱀마다 머리 칸의 Map 인덱스 (죽었으면 -1)
+    const std::vector<int>& getHeads() const { return heads; }
+    Map& getMap() { return map; }
+
+private:
+    Map map;
+    bool joined = false;
+    unsigned player = kSpectator;
+    int height = 0, width = 0;
+    long tick = 0;
+    unsigned snapshots = 0;
+    std::vector<SnakeRecord> snakes;
+    std::vector<int> heads;
+
+    bool applyCells(MessageReader& reader);
+    bool applySnakes(MessageReader& reader);
+};
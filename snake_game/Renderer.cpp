@@ -0,0 +1,208 @@
+#include "Renderer.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int kScoreBoardX = 30;      // 맵이 이 폭보다 좁으면 점수판은 여기에 둔다
+const int kScoreBoardWidth = 13;
+
+const char* cellGlyph(int cell) {
+    switch (cell) {
+        case EMPTY:       return " ";
+        case WALL:        return "#";
+        case IMMUNE_WALL: return "*";
+        case GROWTH_ITEM: return "+";
+        case POISON_ITEM: return "-";
+        case GATE:        return "G";
+        default:          return "?";
+    }
+}
+
+} // namespace
+
+void Renderer::draw(Game& game) {
+    ScoreBoard score;
+    score.length = game.getSnake().getLength();
+    score.maxLength = game.getMaxLength();
+    score.growth = game.getGrowthCount();
+    score.poison = game.getPoisonCount();
+    score.gate = game.getGateUseCount();
+
+    heads.assign(1, game.getSnake().getBody().frontCell());
+    drawFrame(game.getMap(), heads[0], score);
+    game.markRendered();
+}
+
+void Renderer::draw(MultiGame& game, int focus) {
+    heads.resize(game.getSnakeCount());
+    for (int id = 0; id < game.getSnakeCount(); ++id) {
+        const MultiGame::Player& player = game.getPlayer(id);
+        heads[id] = player.isAlive() ? player.snake.getBody().frontCell() : -1;
+    }
+
+    const MultiGame::Player& player = game.getPlayer(focus);
+    ScoreBoard score;
+    score.length = player.isAlive() ? player.snake.getLength() : 0;
+    score.growth = player.growthCount;
+    score.poison = player.poisonCount;
+    score.gate = player.gateUseCount;
+    score.alive = game.getAliveCount();
+    score.snakes = game.getSnakeCount();
+
+    drawFrame(game.getMap(), heads[focus], score);
+    game.markRendered();
+}
+
+void Renderer::draw(Map& map, const std::vector<int>& snakeHeads, int focus,
+                    const ScoreBoard& score) {
+    heads = snakeHeads;
+    drawFrame(map, focus >= 0 ? heads[focus] : -1, score);
+    map.clearDirty();
+}
+
+void Renderer::drawFrame(const Map& map, int focusHead, const ScoreBoard& score) {
+    if (map.getLoadCount() != lastLoadCount || lastHeads.size() != heads.size())
+        fullRedraw = true;
+    if (fullRedraw)
+        fitView(map);
+    // 따라가던 뱀이 죽었으면 창을 그대로 둔다
+    if (!wholeMap && focusHead >= 0 && followHead(map, focusHead))
+        fullRedraw = true;
+
+    if (fullRedraw) {
+        canvas.clear();
+        for (int y = viewTop; y < viewTop + viewRows; ++y)
+            for (int x = viewLeft; x < viewLeft + viewCols; ++x)
+                drawCell(map, map.index(y, x));
+        drawScoreBoardFrame(score.snakes >= 0);
+        drawScoreBoard(score);
+        fullRedraw = false;
+        lastLoadCount = map.getLoadCount();
+    } else {
+        // 맵이 창에 다 들어가면 창 위치가 (0, 0)이라 칸마다 좌표를 옮기거나 범위를 볼 필요가 없다
+        if (wholeMap) {
+            for (int idx : map.getDirtyCells())
+                putCell(map, idx, map.rowOf(idx), map.colOf(idx));
+        } else {
+            for (int idx : map.getDirtyCells())
+                drawCell(map, idx);
+        }
+        // 이전 머리 칸은 점유가 그대로라 변경 목록에 없지만 몸통 글자로 바뀌어야 한다
+        for (std::size_t i = 0; i < heads.size(); ++i) {
+            if (lastHeads[i] != heads[i] && lastHeads[i] >= 0)
+                drawCell(map, lastHeads[i]);
+        }
+        if (!(score == lastScore))
+            drawScoreBoard(score);
+    }
+
+    lastHeads.swap(heads);  // heads는 다음 프레임에 다시 채운다
+    lastScore = score;
+    canvas.flush();
+}
+
+// 전체를 다시 그릴 때마다 창 크기를 캔버스에 맞춘다 (터미널 크기 변경 반영)
+void Renderer::fitView(const Map& map) {
+    viewRows = std::min(map.getHeight(), canvas.getRows());
+    viewCols = std::min(map.getWidth(), std::max(1, canvas.getCols() - kScoreBoardWidth - 2));
+    panelX = std::max(kScoreBoardX, viewCols + 2);
+    // 맵이 창에 다 들어가면 움직일 일이 없다
+    marginY = viewRows < map.getHeight() ? viewRows / 4 : 0;
+    marginX = viewCols < map.getWidth() ? viewCols / 4 : 0;
+    wholeMap = viewRows == map.getHeight() && viewCols == map.getWidth();
+    viewTop = std::min(viewTop, map.getHeight() - viewRows);
+    viewLeft = std::min(viewLeft, map.getWidth() - viewCols);
+}
+
+// 머리가 창 가장자리 1/4 안으로 들어오면 머리가 가운데 오도록 창을 옮긴다. 옮겼으면 true
+bool Renderer::followHead(const Map& map, int head) {
+    int y = map.rowOf(head), x = map.colOf(head);
+    int top = viewTop, left = viewLeft;
+    if (y < top + marginY || y >= top + viewRows - marginY)
+        top = std::max(0, std::min(y - viewRows / 2, map.getHeight() - viewRows));
+    if (x < left + marginX || x >= left + viewCols - marginX)
+        left = std::max(0, std::min(x - viewCols / 2, map.getWidth() - viewCols));
+    bool moved = top != viewTop || left != viewLeft;
+    viewTop = top;
+    viewLeft = left;
+    return moved;
+}
+
+void Renderer::drawCell(const Map& map, int idx) {
+    int y = map.rowOf(idx) - viewTop, x = map.colOf(idx) - viewLeft;
+    if (y < 0 || y >= viewRows || x < 0 || x >= viewCols)
+        return;
+    putCell(map, idx, y, x);
+}
+
+// 화면 좌표 (y, x)에 칸 하나를 찍는다. 창 범위는 부르는 쪽이 확인한다
+void Renderer::putCell(const Map& map, int idx, int y, int x) {
+    if (int owner = map.ownerAt(idx)) {
+        // 0번 뱀(사람)은 O/o, 나머지는 @/x
+        bool head = heads[owner - 1] == idx;
+        if (owner == 1)
+            canvas.put(y, x, head ? "O" : "o");  // Head / Body
+        else
+            canvas.put(y, x, head ? "@" : "x");
+    } else
+        canvas.put(y, x, cellGlyph(map.at(idx)));
+}
+
+void Renderer::drawScoreBoardFrame(bool multi) {
+    int offsetX = panelX;
+    int width = kScoreBoardWidth - 1;
+    int height = 14;
+
+    // 사각형 세로줄
+    for (int y = 0; y < height; ++y) {
+        if (y != 7) {
+            canvas.put(y, offsetX, ".");
+            canvas.put(y, offsetX + width, ".");
+        }
+    }
+
+    // 가로줄
+    canvas.put(0, offsetX, ".............");
+    canvas.put(6, offsetX, ".............");
+    canvas.put(8, offsetX, ".............");
+    canvas.put(13, offsetX, ".............");
+
+    canvas.put(1, offsetX + 1, "Score Board");
+    canvas.put(9, offsetX + 1, multi ? "Snakes" : "Mission");
+}
+
+void Renderer::drawScoreBoard(const ScoreBoard& score) {
+    int offsetX = panelX + 1;
+    char text[32];
+    char line[32];
+
+    // 숫자 자리수가 줄어도 이전 글자가 남지 않게 칸 폭만큼 채워서 쓴다
+    if (score.snakes >= 0)
+        std::snprintf(text, sizeof(text), "B: %d", score.length);
+    else
+        std::snprintf(text, sizeof(text), "B: %d / %d", score.length, score.maxLength);
+    std::snprintf(line, sizeof(line), "%-11s", text);
+    canvas.put(2, offsetX, line);
+    std::snprintf(line, sizeof(line), "+: %-8d", score.growth);
+    canvas.put(3, offsetX, line);
+    std::snprintf(line, sizeof(line), "-: %-8d", score.poison);
+    canvas.put(4, offsetX, line);
+    std::snprintf(line, sizeof(line), "G: %-8d", score.gate);
+    canvas.put(5, offsetX, line);
+
+    if (score.snakes >= 0) {
+        std::snprintf(line, sizeof(line), "Alive: %-4d", score.alive);
+        canvas.put(10, offsetX, line);
+        std::snprintf(line, sizeof(line), "Total: %-4d", score.snakes);
+        canvas.put(11, offsetX, line);
+        return;
+    }
+
+    std::snprintf(line, sizeof(line), "+: 3 (%s)", (score.growth >= 3 ? "v" : " "));
+    canvas.put(10, offsetX, line);
+    std::snprintf(line, sizeof(line), "-: 2 (%s)", (score.poison >= 2 ? "v" : " "));
+    canvas.put(11, offsetX, line);
+    std::snprintf(line, sizeof(line), "G: 1 (%s)", (score.gate >= 1 ? "v" : " "));
+    canvas.put(12, offsetX, line);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include "Canvas.h"
+#include "Game.h"
+#include "MultiGame.h"
+
+// 바뀐 칸만 다시 그리는 게임 화면 렌더러.
+// Map이 모아 둔 변경 칸(값 변경, 뱀 머리/꼬리 점유)과 직전 머리 위치만 다시 찍고,
+// 점수판은 숫자가 바뀐 경우에만 다시 쓴다. 맵을 새로 불러오면 전체를 다시 그린다.
+// 맵이 캔버스보다 크면 머리를 따라가는 창(viewport)만 그리고, 창이 움직이면 다시 그린다.
+// 여러 뱀 경기는 focus번 뱀을 따라가고, 점수판의 미션 칸에 살아 있는 뱀 수를 쓴다.
+class Renderer {
+public:
+    explicit Renderer(Canvas& canvas) : canvas(canvas) {}
+
+    struct ScoreBoard {
+        int length = -1, maxLength = -1;
+        int growth = -1, poison = -1, gate = -1;
+        int alive = -1, snakes = -1;  // 여러 뱀 경기만 (아니면 -1)
+        bool operator==(const ScoreBoard& other) const {
+            return length == other.length && maxLength == other.maxLength &&
+                   growth == other.growth && poison == other.poison && gate == other.gate &&
+                   alive == other.alive && snakes == other.snakes;
+        }
+    };
+
+    void draw(Game& game);
+    void draw(MultiGame& game, int focus);
+    // 게임 객체 없이 맵과 뱀 머리 칸(뱀 번호 순서, 죽었으면 -1)으로 그린다 (원격 화면).
+    // focus가 -1이면 창을 옮기지 않는다.
+    void draw(Map& map, const std::vector<int>& snakeHeads, int focus, const ScoreBoard& score);
+    void invalidate() { fullRedraw = true; }  // 메시지 등으로 화면을 덮은 뒤에 부른다
+    int getPanelX() const { return panelX; }  // 점수판과 안내 문구를 쓰는 열
+
+private:
+    Canvas& canvas;
+    bool fullRedraw = true;
+    unsigned lastLoadCount = 0;
+    std::vector<int> heads;      // 뱀 번호마다 머리 칸 (죽었으면 -1)
+    std::vector<int> lastHeads;  // 직전 프레임의 heads
+    ScoreBoard lastScore;
+    int viewTop = 0, viewLeft = 0;    // 화면 왼쪽 위에 오는 맵 칸
+    int viewRows = 0, viewCols = 0;   // 화면에 보이는 맵 크기
+    int marginY = 0, marginX = 0;     // 머리가 창 가장자리에서 이만큼 안으로 들어오면 창을 옮긴다
+    bool wholeMap = true;             // 맵이 창에 다 들어간다 (창 이동, 칸마다 범위 검사 없음)
+    int panelX = 30;
+
+    void drawFrame(const Map& map, int focusHead, const ScoreBoard& score);
+    void fitView(const Map& map);
+    bool followHead(const Map& map, int head);
+    void drawCell(const Map& map, int idx);
+    void putCell(const Map& map, int idx, int y, int x);
+    void drawScoreBoardFrame(bool multi);
+    void drawScoreBoard(const ScoreBoard& score);
+};
@@ -0,0 +1,200 @@
+#include "Replay.h"
+#include "Map.h"
+#include "StageCache.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char kReplayMagic[4] = {'S', 'N', 'K', 'R'};
+const unsigned char kReplayVersion = 2;  // 2: 경기장 크기 추가 (1도 읽는다)
+const uint64_t kMaxStageCount = 1000;    // 기록은 스테이지 4개로 만든다. 깨진 값으로 맵을 수없이 만들지 않게
+const uint64_t kMinArenaSize = 8;        // --arena와 같은 하한
+const uint64_t kMaxArenaSide = 0x7FFFFFFF;  // fitsIndex에 넘기기 전에 long 넘침을 막는다
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// 읽는 위치를 앞으로 옮긴다. 데이터가 모자라면 false
+bool getVarint(const std::string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        unsigned char byte = in[pos++];
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool saveReplay(const std::string& path, const Replay& replay) {
+    std::string out(kReplayMagic, sizeof(kReplayMagic));
+    out.push_back(kReplayVersion);
+
+    putVarint(out, replay.seed);
+    putVarint(out, replay.config.maxLength);
+    putVarint(out, replay.config.itemLifetimeTicks);
+    putVarint(out, replay.config.stageCount);
+    putVarint(out, replay.config.startStage);
+    putVarint(out, replay.config.arenaHeight);
+    putVarint(out, replay.config.arenaWidth);
+
+    putVarint(out, replay.turns.size());
+    long lastTick = 0;
+    for (const ReplayTurn& turn : replay.turns) {
+        putVarint(out, uint64_t(turn.tick - lastTick) << 2 | turn.dir);
+        lastTick = turn.tick;
+    }
+
+    const ReplayResult& result = replay.result;
+    putVarint(out, result.reason);
+    putVarint(out, result.tick);
+    putVarint(out, result.stage);
+    putVarint(out, result.length);
+    putVarint(out, result.growth);
+    putVarint(out, result.poison);
+    putVarint(out, result.gate);
+    putVarint(out, result.stages.size());
+    for (int stage : result.stages)
+        putVarint(out, stage);
+
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout.is_open())
+        return false;
+    fout.write(out.data(), out.size());
+    return fout.good();
+}
+
+bool loadReplay(const std::string& path, Replay& replay) {
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin.is_open())
+        return false;
+    std::string in((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    if (in.size() < sizeof(kReplayMagic) + 1 ||
+        std::memcmp(in.data(), kReplayMagic, sizeof(kReplayMagic)) != 0)
+        return false;
+    unsigned char version = in[sizeof(kReplayMagic)];
+    if (version < 1 || version > kReplayVersion)
+        return false;
+    size_t pos = sizeof(kReplayMagic) + 1;
+
+    uint64_t v[7] = {};
+    int fields = version >= 2 ? 7 : 5;
+    for (int i = 0; i < fields; ++i) {
+        if (!getVarint(in, pos, v[i])) return false;
+    }
+    // 스테이지 수와 시작 스테이지, 경기장 크기(0x0이면 스테이지 파일을 쓴다)가 게임이 받는 범위인지 본다
+    uint64_t stageCount = v[3], startStage = v[4], arenaHeight = v[5], arenaWidth = v[6];
+    if (stageCount < 1 || stageCount > kMaxStageCount || startStage < 1 || startStage > stageCount)
+        return false;
+    if ((arenaHeight || arenaWidth) &&
+        (arenaHeight < kMinArenaSize || arenaWidth < kMinArenaSize ||
+         arenaHeight > kMaxArenaSide || arenaWidth > kMaxArenaSide ||
+         !Map::fitsIndex(long(arenaHeight), long(arenaWidth))))
+        return false;
+    // 스테이지 파일을 쓰는 기록이면 stageCount개가 모두 읽혀야 재생할 수 있다 (경기장은 늘 만들어진다)
+    if (arenaHeight == 0 && StageCache(int(stageCount)).getFailedStage() != 0)
+        return false;
+    replay.seed = v[0];
+    replay.config.maxLength = v[1];
+    replay.config.itemLifetimeTicks = v[2];
+    replay.config.stageCount = v[3];
+    replay.config.startStage = v[4];
+    replay.config.arenaHeight = v[5];
+    replay.config.arenaWidth = v[6];
+
+    uint64_t count;
+    if (!getVarint(in, pos, count)) return false;
+    replay.turns.clear();
+    long tick = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t packed;
+        if (!getVarint(in, pos, packed)) return false;
+        tick += packed >> 2;
+        replay.turns.push_back({tick, static_cast<Direction>(packed & 3)});
+    }
+
+    uint64_t r[8];
+    for (uint64_t& value : r) {
+        if (!getVarint(in, pos, value)) return false;
+    }
+    ReplayResult& result = replay.result;
+    result.reason = static_cast<GameOverReason>(r[0]);
+    result.tick = r[1];
+    result.stage = r[2];
+    result.length = r[3];
+    result.growth = r[4];
+    result.poison = r[5];
+    result.gate = r[6];
+    result.stages.clear();
+    for (uint64_t i = 0; i < r[7]; ++i) {
+        uint64_t stage;
+        if (!getVarint(in, pos, stage)) return false;
+        result.stages.push_back(stage);
+    }
+    return true;
+}
+
+void ReplayRecorder::begin(const Game& game, uint64_t seed) {
+    replay = Replay();
+    replay.seed = seed;
+    replay.config = game.getConfig();
+    replay.result.stages.push_back(game.getStage());
+}
+
+// 현재 방향과 다른 입력만 남긴다 (반대 방향으로 끝난 경우도 기록된다)
+void ReplayRecorder::recordInput(const Game& game, Direction action) {
+    if (action != game.getSnake().getDirection())
+        replay.turns.push_back({game.getTick(), action});
+}
+
+void ReplayRecorder::recordEvents(const Game& game, const StepEvents& events) {
+    if (events.stageCleared)
+        replay.result.stages.push_back(game.getStage());
+    if (events.gameOver != OVER_NONE) {
+        std::vector<int> stages = std::move(replay.result.stages);
+        replay.result = resultOf(game, stages);
+    }
+}
+
+Direction ReplayPlayer::nextAction(const Game& game) {
+    if (next < replay.turns.size() && replay.turns[next].tick == game.getTick())
+        return replay.turns[next++].dir;
+    return game.getSnake().getDirection();
+}
+
+ReplayResult resultOf(const Game& game, const std::vector<int>& stages) {
+    ReplayResult result;
+    result.reason = game.getOverReason();
+    result.tick = game.getTick();
+    result.stage = game.getStage();
+    result.length = game.getSnake().getLength();
+    result.growth = game.getGrowthCount();
+    result.poison = game.getPoisonCount();
+    result.gate = game.getGateUseCount();
+    result.stages = stages;
+    return result;
+}
+
+ReplayResult playReplay(const Replay& replay, std::shared_ptr<const StageCache> stages) {
+    Game game(replay.config, std::move(stages));
+    game.reset(replay.seed);
+    ReplayPlayer player(replay);
+    std::vector<int> visited = {game.getStage()};
+
+    while (!game.isOver() && game.getTick() <= replay.result.tick) {
+        StepEvents events = game.step(player.nextAction(game));
+        if (events.stageCleared)
+            visited.push_back(game.getStage());
+    }
+    return resultOf(game, visited);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Game.h"
+
+// 한 게임의 입력 기록 (.rpl).
+// 시드와 설정, 방향을 바꾼 (틱, 방향)만 저장하고, 나머지 틱은 현재 방향 그대로라고 본다.
+// 같은 시드와 입력이면 Game이 같은 결과를 내므로 끝난 상태를 같이 저장해 두고 재생 결과와 비교한다.
+
+struct ReplayTurn {
+    long tick;
+    Direction dir;
+};
+
+struct ReplayResult {
+    GameOverReason reason = OVER_NONE;
+    long tick = 0;
+    int stage = 0;
+    int length = 0;
+    int growth = 0, poison = 0, gate = 0;
+    std::vector<int> stages;  // 거쳐 간 스테이지 순서
+
+    bool operator==(const ReplayResult& other) const {
+        return reason == other.reason && tick == other.tick && stage == other.stage &&
+               length == other.length && growth == other.growth && poison == other.poison &&
+               gate == other.gate && stages == other.stages;
+    }
+    bool operator!=(const ReplayResult& other) const { return !(*this == other); }
+};
+
+struct Replay {
+    uint64_t seed = 0;
+    GameConfig config;
+    std::vector<ReplayTurn> turns;
+    ReplayResult result;
+};
+
+// 파일 형식: "SNKR", 버전 1바이트, 이후 값은 모두 LEB128 varint.
+// 버전 2부터 설정 뒤에 경기장 크기(높이, 너비)가 붙는다.
+// 방향 전환은 직전 전환과의 틱 차이를 2비트 왼쪽으로 밀고 방향을 붙여 한 값으로 쓴다.
+bool saveReplay(const std::string& path, const Replay& replay);
+bool loadReplay(const std::string& path, Replay& replay);
+
+// 게임을 진행하면서 기록을 만든다. reset 직후 begin, step마다 앞뒤로 한 번씩 부른다.
+class ReplayRecorder {
+public:
+    void begin(const Game& game, uint64_t seed);
+    void recordInput(const Game& game, Direction action);
+    void recordEvents(const Game& game, const StepEvents& events);
+    const Replay& getReplay() const { return replay; }
+
+private:
+    Replay replay;
+};
+
+// 기록대로 방향을 내준다
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay) : replay(replay) {}
+    Direction nextAction(const Game& game);
+
+private:
+    const Replay& replay;
+    size_t next = 0;
+};
+
+ReplayResult resultOf(const Game& game, const std::vector<int>& stages);
+
+// 화면 없이 최대 속도로 재생한 결과. 기록된 틱보다 오래 가면 멈춘다.
+ReplayResult playReplay(const Replay& replay, std::shared_ptr<const StageCache> stages = nullptr);
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+// 게임 인스턴스마다 따로 가지는 난수 생성기 (xoshiro256**).
+// 전역 rand()와 달리 스레드끼리 상태를 공유하지 않고, 같은 시드면 같은 게임이 나온다.
+// 상태가 32바이트라 VecEnv처럼 게임마다 하나씩 들고 있어도 부담이 없다.
+class Rng {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    explicit Rng(uint64_t seed = 1) { this->seed(seed); }
+
+    // 시드 하나를 splitmix64로 펼쳐서 상태를 채운다 (상태가 전부 0이 되지 않는다)
+    void seed(uint64_t value) {
+        for (uint64_t& s : state) {
+            uint64_t z = (value += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, bound) 범위의 균등한 정수 (Lemire 방식, 나머지 연산의 치우침이 없다).
+    // 곱셈 한 번으로 범위를 줄이고, 드물게 치우치는 구간에 걸릴 때만 다시 뽑는다.
+    int below(int bound) {
+        uint32_t range = bound;
+        uint64_t m = uint64_t(uint32_t(next() >> 32)) * range;
+        uint32_t low = uint32_t(m);
+        if (low < range) {
+            uint32_t threshold = -range % range;
+            while (low < threshold) {
+                m = uint64_t(uint32_t(next() >> 32)) * range;
+                low = uint32_t(m);
+            }
+        }
+        return m >> 32;
+    }
+};
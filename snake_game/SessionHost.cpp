@@ -0,0 +1,269 @@
+#include "SessionHost.h"
+#include "Socket.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+const int kMaxEvents = 128;
+const int kItemLifetimeMs = 10 * 1000;  // 아이템 재배치 주기
+const uint64_t kWakeKey = ~uint64_t(0);
+// epoll 키: 슬롯 번호 * 2 (+1이면 타이머)
+const uint64_t kTimerBit = 1;
+const uint64_t kSeedStride = 1 << 20;
+
+GameConfig makeConfig(const HostOptions& options) {
+    GameConfig config;
+    config.itemLifetimeTicks = (kItemLifetimeMs + options.tickMs - 1) / options.tickMs;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    return config;
+}
+
+bool watch(int epollFd, int fd, uint32_t events, uint64_t key) {
+    epoll_event event = {};
+    event.events = events;
+    event.data.u64 = key;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+} // namespace
+
+SessionHost::SessionHost(const HostOptions& options)
+    : options(options), config(makeConfig(options)) {
+    // 모든 세션이 같은 스테이지 템플릿을 읽기만 한다
+    stages = std::make_shared<const StageCache>(config.stageCount, config.arenaHeight,
+                                                config.arenaWidth);
+    nextSeed = options.fixedSeed ? options.seed : time(nullptr);
+
+    int threads = options.threads;
+    if (threads <= 0)
+        threads = std::max(1, std::min<int>(std::thread::hardware_concurrency(), kMaxDefaultThreads));
+    for (int i = 0; i < threads; ++i)
+        workers.push_back(std::make_unique<Worker>());
+}
+
+SessionHost::~SessionHost() {
+    for (auto& worker : workers) {
+        for (int fd : worker->inbox) close(fd);
+        if (worker->epollFd >= 0) close(worker->epollFd);
+        if (worker->wakeFd >= 0) close(worker->wakeFd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        removeSocketFile(options.address);
+    }
+}
+
+int SessionHost::run() {
+    // 시그널은 메인 스레드의 signalfd로만 받는다 (워커는 마스크를 물려받는다)
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    listenFd = listenOn(options.address);
+    if (listenFd < 0) return 1;
+    int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (signalFd < 0 || epollFd < 0 || !watch(epollFd, listenFd, EPOLLIN, 0) ||
+        !watch(epollFd, signalFd, EPOLLIN, 1)) {
+        std::perror("epoll");
+        return 1;
+    }
+
+    for (auto& worker : workers) {
+        worker->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        worker->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (worker->epollFd < 0 || worker->wakeFd < 0 ||
+            !watch(worker->epollFd, worker->wakeFd, EPOLLIN, kWakeKey)) {
+            std::perror("epoll");
+            return 1;
+        }
+    }
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { serve(*w); });
+    }
+
+    std::printf("hosting on %s: %zu threads, %d ms ticks\n", options.address.c_str(),
+                workers.size(), options.tickMs);
+    std::fflush(stdout);
+
+    bool running = true;
+    while (running) {
+        epoll_event events[2];
+        int n = epoll_wait(epollFd, events, 2, -1);
+        if (n < 0 && errno != EINTR) {
+            std::perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.u64 == 0)
+                acceptClients();
+            else
+                running = false;
+        }
+    }
+
+    stopping = true;
+    for (auto& worker : workers) {
+        uint64_t one = 1;
+        if (write(worker->wakeFd, &one, sizeof(one)) < 0) std::perror("eventfd");
+    }
+    for (auto& worker : workers)
+        worker->thread.join();
+    close(epollFd);
+    close(signalFd);
+
+    printStats();
+    return 0;
+}
+
+// 접속을 워커에 차례로 나눠 준다. 세션은 넘겨받은 워커 스레드에서 만든다.
+void SessionHost::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::perror("accept");
+            return;
+        }
+        setNoDelay(fd);
+
+        Worker& worker = *workers[accepted++ % workers.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.inboxLock);
+            worker.inbox.push_back(fd);
+        }
+        uint64_t one = 1;
+        if (write(worker.wakeFd, &one, sizeof(one)) < 0) std::perror("eventfd");
+    }
+}
+
+void SessionHost::serve(Worker& worker) {
+    epoll_event events[kMaxEvents];
+    while (!stopping) {
+        int n = epoll_wait(worker.epollFd, events, kMaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t key = events[i].data.u64;
+            if (key == kWakeKey) {
+                adopt(worker);
+                continue;
+            }
+            int slot = int(key >> 1);
+            TerminalSession* session = worker.slots[slot].get();
+            // 같은 묶음에서 먼저 처리한 이벤트로 이미 닫혔을 수 있다
+            if (!session || !session->isOpen()) continue;
+
+            if (key & kTimerBit) {
+                session->onTimer();
+            } else {
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) session->onReadable();
+                if (session->isOpen() && (events[i].events & EPOLLOUT)) session->onWritable();
+            }
+            worker.touched.push_back(slot);
+        }
+
+        // 닫힌 세션 정리와 EPOLLOUT 갱신은 묶음을 다 처리한 뒤에 한다 (슬롯 재사용 방지)
+        for (int slot : worker.touched)
+            update(worker, slot);
+        worker.touched.clear();
+    }
+
+    for (auto& session : worker.slots) {
+        if (session) worker.stats += session->getStats();
+    }
+    worker.slots.clear();
+}
+
+// 메인 스레드가 넘긴 접속으로 세션을 만든다
+void SessionHost::adopt(Worker& worker) {
+    uint64_t count;
+    if (read(worker.wakeFd, &count, sizeof(count)) < 0) return;
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lock(worker.inboxLock);
+        fds.swap(worker.inbox);
+    }
+
+    for (int fd : fds) {
+        int slot;
+        if (!worker.freeSlots.empty()) {
+            slot = worker.freeSlots.back();
+            worker.freeSlots.pop_back();
+        } else {
+            slot = worker.slots.size();
+            worker.slots.emplace_back();
+            worker.writeArmed.push_back(0);
+        }
+        // 세션마다 시드를 크게 떨어뜨려 둔다 (다시 하기는 1씩 늘린다)
+        uint64_t sessionSeed = nextSeed.fetch_add(kSeedStride);
+        auto session = std::make_unique<TerminalSession>(fd, config, stages, options.tickMs,
+                                                         sessionSeed, options.rows, options.cols);
+        uint64_t key = uint64_t(slot) << 1;
+        if (!session->isOpen() ||
+            !watch(worker.epollFd, session->getFd(), EPOLLIN | EPOLLRDHUP, key) ||
+            !watch(worker.epollFd, session->getTimerFd(), EPOLLIN, key | kTimerBit)) {
+            worker.freeSlots.push_back(slot);
+            continue;  // 세션을 지우면 fd도 닫힌다
+        }
+        worker.writeArmed[slot] = 0;
+        worker.slots[slot] = std::move(session);
+        worker.slots[slot]->start();
+        worker.touched.push_back(slot);
+        worker.peakSessions = std::max(worker.peakSessions, ++worker.sessions);
+    }
+}
+
+void SessionHost::update(Worker& worker, int slot) {
+    std::unique_ptr<TerminalSession>& session = worker.slots[slot];
+    if (!session) return;  // 같은 묶음에서 두 번 들어온 슬롯
+    if (!session->isOpen()) {
+        worker.stats += session->getStats();
+        session.reset();  // 소켓과 타이머를 닫으면 epoll에서도 빠진다
+        worker.freeSlots.push_back(slot);
+        --worker.sessions;
+        return;
+    }
+    char wants = session->wantsWrite();
+    if (wants != worker.writeArmed[slot]) {
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP | (wants ? EPOLLOUT : 0);
+        event.data.u64 = uint64_t(slot) << 1;
+        epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, session->getFd(), &event);
+        worker.writeArmed[slot] = wants;
+    }
+}
+
+void SessionHost::printStats() const {
+    SessionStats total;
+    std::printf("\nsessions   %ld accepted\n", accepted);
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        const Worker& worker = *workers[i];
+        total += worker.stats;
+        std::printf("worker %zu   peak %d sessions, %ld ticks\n", i, worker.peakSessions,
+                    worker.stats.ticks);
+    }
+    std::printf("ticks      %ld (%ld overruns)\n", total.ticks, total.overruns);
+    if (total.ticks > 0) {
+        std::printf("output     %.1f bytes avg per tick\n", double(total.bytesOut) / total.ticks);
+        std::printf("step+draw  %.2f us avg per tick\n", total.frameNs / total.ticks / 1000);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Game.h"
+#include "TerminalSession.h"
+
+struct HostOptions {
+    std::string address;   // 유닉스 소켓 경로 또는 TCP 포트 번호 (127.0.0.1)
+    int tickMs = 150;
+    int threads = 0;       // 0이면 코어 수 (최대 kMaxDefaultThreads)
+    int arenaHeight = 0;   // 0보다 크면 스테이지 대신 빈 경기장
+    int arenaWidth = 0;
+    bool fixedSeed = false;
+    uint64_t seed = 0;
+    int rows = 24;         // 세션 화면 크기 (소켓으로는 터미널 크기를 알 수 없다)
+    int cols = 80;
+};
+
+// 한 프로세스에서 서로 상관없는 1인용 게임 여러 개를 돌리는 호스트 (오락실 한 대에 여러 사람).
+// 접속 하나가 세션 하나이고, 접속한 터미널(raw 모드)에 ANSI로 직접 그린다.
+//   socat -,raw,echo=0 UNIX-CONNECT:/tmp/arcade.sock
+// 메인 스레드는 접속을 받아 세션을 워커에 번갈아 넘기고, 시그널은 signalfd로 받는다.
+// 워커 스레드는 정해진 수만큼만 두고, 각자 epoll 하나로 자기 세션들의 소켓과 timerfd를 기다린다.
+// 세션은 한 워커에서만 만지므로 세션 상태에는 잠금이 없다 (넘겨받는 대기열만 잠근다).
+class SessionHost {
+public:
+    static const int kMaxDefaultThreads = 4;
+
+    explicit SessionHost(const HostOptions& options);
+    ~SessionHost();
+
+    int run();  // SIGINT/SIGTERM을 받을 때까지 돈다. 시작하지 못하면 1
+
+private:
+    struct Worker {
+        std::thread thread;
+        int epollFd = -1;
+        int wakeFd = -1;                 // eventfd. 새 세션이 왔거나 멈출 때
+        std::mutex inboxLock;
+        std::vector<int> inbox;          // 메인 스레드가 넘긴 접속 fd
+        std::vector<std::unique_ptr<TerminalSession>> slots;
+        std::vector<int> freeSlots;
+        std::vector<int> touched;        // 이번 epoll_wait에서 이벤트를 받은 슬롯
+        std::vector<char> writeArmed;    // 슬롯마다 EPOLLOUT을 걸어 두었는지
+        int sessions = 0;
+        int peakSessions = 0;
+        SessionStats stats;              // 끝난 세션 것까지 모은 통계
+    };
+
+    HostOptions options;
+    GameConfig config;
+    std::shared_ptr<const StageCache> stages;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> nextSeed{0};  // 워커가 세션을 만들 때 가져간다
+    int listenFd = -1;
+    long accepted = 0;
+
+    void acceptClients();
+    void serve(Worker& worker);
+    void adopt(Worker& worker);
+    void update(Worker& worker, int slot);
+    void printStats() const;
+};
@@ -1,67 +1,63 @@
 #include "Snake.h"
 #include "Map.h"
-#include <ncurses.h>
-#include <tuple>
-#include <deque>
 
 const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN
 const int dx[4] = {0, 0, -1, 1}; // LEFT, RIGHT
-
-void Snake::init(int y, int x) {
-    body.clear();
-    body.push_back({y, x});     // Head
-    body.push_back({y, x - 1}); // Body1
-    body.push_back({y, x - 2}); // Body2
+const long kInitialBodyCapacity = 1024;
+
+// 맵을 새로 불러온 직후에 호출한다 (이전 몸통 점유는 맵을 불러올 때 지워진다)
+void Snake::init(Map& map, int y, int x, int owner) {
+    // 몸통은 맵의 안쪽 칸 수보다 길어질 수 없다 (머리를 먼저 넣으므로 +1).
+    // 큰 맵에서는 처음부터 다 잡지 않고 길어질 때 늘린다.
+    long area = long(map.getHeight()) * map.getWidth() + 1;
+    body.reset(area < kInitialBodyCapacity ? area : kInitialBodyCapacity, map.getStride());
+    body.pushBack(map.index(y, x));     // Head
+    body.pushBack(map.index(y, x - 1)); // Body1
+    body.pushBack(map.index(y, x - 2)); // Body2
+    this->owner = owner;
+    for (size_t i = 0; i < body.size(); ++i)
+        map.occupy(body.cellAt(i), owner);
     direction = RIGHT;
 }
 
-void Snake::render() const {
-    for (size_t i = 0; i < body.size(); ++i) {
-        int y = body[i].first;
-        int x = body[i].second;
-        if (i == 0)
-            mvprintw(y, x, "O");  // Head
-        else
-            mvprintw(y, x, "o");  // Body
-    }
-}
-
+// planMove + isBlocked + applyMove와 같은 규칙이다.
+// 한 마리만 움직일 때는 함수 호출 두 번도 틱 시간에 보여서 나누지 않고 한 번에 처리한다.
 Snake::MoveResult Snake::move(Map& map) {
-    auto [headY, headX] = body.front();
-    int newY = headY + dy[direction];
-    int newX = headX + dx[direction];
-
-    int cell = map.getValue(newY, newX);
+    // 머리는 항상 맵 안쪽에 있으므로 이웃 칸은 센티넬 테두리 안에 있다
+    int newIdx = body.frontCell() + dy[direction] * map.getStride() + dx[direction];
+    int cell = map.at(newIdx);
     bool usedGate = false;
 
     if (cell == GATE) {
-        std::pair<int, int> outGate = (newY == gate1.first && newX == gate1.second) ? gate2 : gate1;
-        std::tie(newY, newX) = getGateExitPosition(map, outGate);
+        // 게이트 옆 칸이 바뀐 경우에만 출구 표를 다시 만든다
+        if (!gates.isCurrent(map))
+            gates.rebuild(map);
+        const GateTable::Exit* exit = gates.lookup(newIdx, direction);
+        if (!exit)
+            return MOVE_DEAD;  // 짝이 없는 게이트 칸은 벽이다
+        newIdx = exit->cell;
+        direction = exit->dir;
         usedGate = true;
     }
 
-    for (const auto& segment : body) {
-        if (segment.first == newY && segment.second == newX)
-            return MOVE_DEAD;
-    }
-
-    if (map.getValue(newY, newX) == WALL || map.getValue(newY, newX) == IMMUNE_WALL)
+    if (isBlocked(map, newIdx))
         return MOVE_DEAD;
 
-    body.push_front({newY, newX});
+    body.pushFront(newIdx);
+    map.occupy(newIdx, owner);
 
     if (cell == GROWTH_ITEM) {
-        map.setValue(newY, newX, EMPTY);
+        map.setAt(newIdx, EMPTY);
         return MOVE_GROWTH;
     } else if (cell == POISON_ITEM) {
-        map.setValue(newY, newX, EMPTY);
-        if (body.size() > 1) body.pop_back();
-        if (body.size() > 1) body.pop_back();
+        map.setAt(newIdx, EMPTY);
+        if (body.size() > 1) popTail(map);
+        if (body.size() > 1) popTail(map);
         if (body.size() < 3)
             return MOVE_DEAD;
         return MOVE_POISON;
     } else {
-        body.pop_back();
+        popTail(map);
     }
 
     if (body.size() < 3)
@@ -73,17 +69,69 @@ Snake::MoveResult Snake::move(Map& map) {
     return MOVE_NORMAL;
 }
 
+Snake::Plan Snake::planMove(const Map& map, GateTable& gateTable) const {
+    Plan plan;
+    plan.cell = body.frontCell() + dy[direction] * map.getStride() + dx[direction];
+    plan.dir = direction;
+    plan.item = map.at(plan.cell);
+    plan.usedGate = plan.item == GATE;
+    plan.deadEnd = false;
+
+    if (plan.usedGate) {
+        // 게이트 옆 칸이 바뀐 경우에만 출구 표를 다시 만든다
+        if (!gateTable.isCurrent(map))
+            gateTable.rebuild(map);
+        const GateTable::Exit* exit = gateTable.lookup(plan.cell, direction);
+        if (!exit) {
+            plan.deadEnd = true;  // 짝이 없는 게이트 칸은 벽이다
+            return plan;
+        }
+        plan.cell = exit->cell;
+        plan.dir = exit->dir;
+    }
+    return plan;
+}
+
+Snake::MoveResult Snake::applyMove(Map& map, const Plan& plan) {
+    int newIdx = plan.cell;
+    direction = plan.dir;
+    body.pushFront(newIdx);
+    map.occupy(newIdx, owner);
 
-bool Snake::updateDirection(int key) {
-    Direction newDir = direction;
-    switch (key) {
-        case KEY_UP:    newDir = UP; break;
-        case KEY_DOWN:  newDir = DOWN; break;
-        case KEY_LEFT:  newDir = LEFT; break;
-        case KEY_RIGHT: newDir = RIGHT; break;
-        default: return true;
+    if (plan.item == GROWTH_ITEM) {
+        map.setAt(newIdx, EMPTY);
+        return MOVE_GROWTH;
+    } else if (plan.item == POISON_ITEM) {
+        map.setAt(newIdx, EMPTY);
+        if (body.size() > 1) popTail(map);
+        if (body.size() > 1) popTail(map);
+        if (body.size() < 3)
+            return MOVE_DEAD;
+        return MOVE_POISON;
+    } else {
+        popTail(map);
     }
 
+    if (body.size() < 3)
+        return MOVE_DEAD;
+
+    if (plan.usedGate)
+        return MOVE_GATE;
+
+    return MOVE_NORMAL;
+}
+
+void Snake::clear(Map& map) {
+    while (!body.empty())
+        popTail(map);
+}
+
+void Snake::popTail(Map& map) {
+    map.vacate(body.backCell());
+    body.popBack();
+}
+
+bool Snake::updateDirection(Direction newDir) {
     if ((direction == UP && newDir == DOWN) ||
         (direction == DOWN && newDir == UP) ||
         (direction == LEFT && newDir == RIGHT) ||
@@ -98,63 +146,14 @@ bool Snake::updateDirection(int key) {
 Direction Snake::getDirection() const {
     return direction;
 }
-void Snake::setGateInfo(std::pair<int, int> g1, std::pair<int, int> g2) {
-    gate1 = g1;
-    gate2 = g2;
+void Snake::setGates(const Map& map, const std::vector<int>& gateCells) {
+    gates.build(map, gateCells);
 }
 
-
-std::pair<int, int> Snake::getGateExitPosition(const Map& map, std::pair<int, int> gate) {
-    int y = gate.first;
-    int x = gate.second;
-
-    Direction priority[4];
-
-    switch (direction) {
-        case UP:
-            priority[0] = UP;
-            priority[1] = RIGHT;
-            priority[2] = LEFT;
-            priority[3] = DOWN;
-            break;
-        case DOWN:
-            priority[0] = DOWN;
-            priority[1] = LEFT;
-            priority[2] = RIGHT;
-            priority[3] = UP;
-            break;
-        case LEFT:
-            priority[0] = LEFT;
-            priority[1] = UP;
-            priority[2] = DOWN;
-            priority[3] = RIGHT;
-            break;
-        case RIGHT:
-            priority[0] = RIGHT;
-            priority[1] = DOWN;
-            priority[2] = UP;
-            priority[3] = LEFT;
-            break;
-    }
-
-    for (int i = 0; i < 4; ++i) {
-        int dir = priority[i];
-        int ny = y + dy[dir];
-        int nx = x + dx[dir];
-
-        int val = map.getValue(ny, nx);
-        if (val == EMPTY || val == GROWTH_ITEM || val == POISON_ITEM) {
-            direction = static_cast<Direction>(dir);  // ✅ 새로운 이동 방향 설정
-            return {ny, nx};  // ✅ 게이트 탈출 위치
-        }
-    }
-
-    return gate;  // 이동 불가하면 제자리
-}
 int Snake::getLength() const {
     return body.size();
 }
-const std::deque<std::pair<int,int>>& Snake::getBody() const {
+const SnakeBody& Snake::getBody() const {
     return body;
 }
 
@@ -1,9 +1,9 @@
 #pragma once
-#include <deque>
 #include <utility>
+#include "Direction.h"
+#include "GateTable.h"
 #include "Map.h"
-
-enum Direction { UP = 0, DOWN, LEFT, RIGHT };
+#include "SnakeBody.h"
 
 class Snake {
 public:
@@ -15,21 +15,45 @@ public:
         MOVE_DEAD
     };
 
+    // 여러 뱀이 동시에 움직일 때 머리가 들어갈 칸을 먼저 모두 정하고, 충돌을 가린 뒤 옮긴다
+    struct Plan {
+        int cell;         // 머리가 들어갈 칸 (게이트를 지났으면 출구 칸)
+        Direction dir;    // 이동 후 진행 방향
+        CellType item;    // 원래 그 칸에 있던 것 (게이트를 지났으면 GATE)
+        bool usedGate;
+        bool deadEnd;     // 표에 없는 게이트라 못 들어간다 (cell은 그 게이트 칸)
+    };
+
 private:
-    std::deque<std::pair<int, int>> body;
+    SnakeBody body;
     Direction direction;
-    std::pair<int, int> gate1, gate2;
+    GateTable gates;
+    int owner = 1;  // Map 점유 표시에 쓰는 번호 (뱀 번호 + 1)
+
+    void popTail(Map& map);
 
 public:
-    void init(int y, int x);
-    void render() const;
+    void init(Map& map, int y, int x, int owner = 1);
     MoveResult move(Map& map);  // 🔁 바뀐 시그니처
-    bool updateDirection(int key);
+
+    // move를 둘로 나눈 것. planMove는 맵을 바꾸지 않고(게이트 표만 필요하면 다시 만든다),
+    // 막힌 칸인지는 deadEnd와 isBlocked로 따로 보고, applyMove가 머리를 넣고 꼬리를 당긴다.
+    Plan planMove(const Map& map, GateTable& gateTable) const;
+    static bool isBlocked(const Map& map, int cell) {
+        // 꼬리도 아직 비워지기 전이므로 점유 표시로 몸통 충돌을 바로 판정한다
+        if (map.isOccupied(cell)) return true;
+        int target = map.at(cell);
+        return target == WALL || target == IMMUNE_WALL;
+    }
+    MoveResult applyMove(Map& map, const Plan& plan);
+    void clear(Map& map);  // 죽은 뱀의 몸통 점유를 모두 지운다
+    bool updateDirection(Direction newDir);  // 반대 방향이면 false
     Direction getDirection() const;
-    void setGateInfo(std::pair<int, int> g1, std::pair<int, int> g2);
-    std::pair<int, int> getGateExitPosition(const Map& map, std::pair<int, int> gate);
+    // 게이트 셀 인덱스 (2k와 2k+1이 한 쌍), 출구 표를 만든다
+    void setGates(const Map& map, const std::vector<int>& gateCells);
     int getLength() const;
-    const std::deque<std::pair<int,int>>& getBody() const;
+    int getOwner() const { return owner; }
+    const SnakeBody& getBody() const;
 
 };
 
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// 뱀 몸통을 담는 링 버퍼.
+// 각 마디는 Map 셀 인덱스 하나(int)로 저장하고, 용량은 2의 거듭제곱이다.
+// 가득 찬 상태에서 자랄 때만 두 배로 늘리므로 보통의 이동에는 메모리 할당이 없다.
+// 0번이 머리, size()-1번이 꼬리.
+class SnakeBody {
+private:
+    std::vector<int> cells;
+    unsigned mask = 0;
+    unsigned head = 0;   // 머리가 들어있는 슬롯
+    unsigned count = 0;
+    int stride = 1;      // 셀 인덱스 -> (y, x) 변환용 Map 행 폭
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<int, int>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator(const SnakeBody* body, unsigned pos) : body(body), pos(pos) {}
+        value_type operator*() const { return (*body)[pos]; }
+        const_iterator& operator++() { ++pos; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++pos; return old; }
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+
+    private:
+        const SnakeBody* body;
+        unsigned pos;
+    };
+
+    // minCapacity 이상인 가장 작은 2의 거듭제곱으로 버퍼를 잡는다
+    void reset(std::size_t minCapacity, int mapStride) {
+        std::size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        if (cells.size() != capacity) cells.assign(capacity, 0);
+        mask = capacity - 1;
+        head = 0;
+        count = 0;
+        stride = mapStride;
+    }
+
+    void pushFront(int cell) {
+        if (count == cells.size()) grow();
+        head = (head - 1) & mask;
+        cells[head] = cell;
+        ++count;
+    }
+    void pushBack(int cell) {
+        if (count == cells.size()) grow();
+        cells[(head + count) & mask] = cell;
+        ++count;
+    }
+    void popBack() { --count; }
+
+    int frontCell() const { return cells[head]; }
+    int backCell() const { return cells[(head + count - 1) & mask]; }
+    int cellAt(std::size_t i) const { return cells[(head + i) & mask]; }
+
+    std::pair<int, int> operator[](std::size_t i) const {
+        int cell = cellAt(i);
+        return {cell / stride - 1, cell % stride - 1};
+    }
+    std::pair<int, int> front() const { return (*this)[0]; }
+    std::pair<int, int> back() const { return (*this)[count - 1]; }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t capacity() const { return cells.size(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    // 머리부터 순서대로 두 배 크기 버퍼에 옮긴다
+    void grow() {
+        std::vector<int> larger(cells.size() * 2);
+        for (unsigned i = 0; i < count; ++i)
+            larger[i] = cells[(head + i) & mask];
+        cells.swap(larger);
+        mask = cells.size() - 1;
+        head = 0;
+    }
+};
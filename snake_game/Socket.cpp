@@ -0,0 +1,97 @@
+#include "Socket.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// 주소를 채우고 크기를 돌려준다. 경로가 너무 길면 0
+socklen_t fillAddress(const std::string& address, sockaddr_storage& storage) {
+    std::memset(&storage, 0, sizeof(storage));
+    if (isTcpAddress(address)) {
+        sockaddr_in& in = reinterpret_cast<sockaddr_in&>(storage);
+        in.sin_family = AF_INET;
+        in.sin_port = htons(std::atoi(address.c_str()));
+        in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return sizeof(in);
+    }
+    sockaddr_un& un = reinterpret_cast<sockaddr_un&>(storage);
+    if (address.size() >= sizeof(un.sun_path)) return 0;
+    un.sun_family = AF_UNIX;
+    std::memcpy(un.sun_path, address.c_str(), address.size() + 1);
+    return sizeof(un);
+}
+
+int fail(const char* what, const std::string& address, int fd) {
+    std::fprintf(stderr, "%s %s: %s\n", what, address.c_str(), std::strerror(errno));
+    if (fd >= 0) close(fd);
+    return -1;
+}
+
+} // namespace
+
+bool isTcpAddress(const std::string& address) {
+    return !address.empty() && address.find_first_not_of("0123456789") == std::string::npos;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void setNoDelay(int fd) {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+int listenOn(const std::string& address) {
+    sockaddr_storage storage;
+    socklen_t size = fillAddress(address, storage);
+    if (size == 0) {
+        std::fprintf(stderr, "socket path too long: %s\n", address.c_str());
+        return -1;
+    }
+    int fd = socket(storage.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) return fail("socket", address, fd);
+
+    if (isTcpAddress(address)) {
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    } else {
+        removeSocketFile(address);  // 이전 서버가 남긴 소켓 파일
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&storage), size) < 0) return fail("bind", address, fd);
+    if (listen(fd, 128) < 0) return fail("listen", address, fd);
+    if (!setNonBlocking(fd)) return fail("fcntl", address, fd);
+    return fd;
+}
+
+void removeSocketFile(const std::string& address) {
+    struct stat st;
+    if (!isTcpAddress(address) && lstat(address.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(address.c_str());
+}
+
+int connectTo(const std::string& address) {
+    sockaddr_storage storage;
+    socklen_t size = fillAddress(address, storage);
+    if (size == 0) {
+        std::fprintf(stderr, "socket path too long: %s\n", address.c_str());
+        return -1;
+    }
+    int fd = socket(storage.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) return fail("socket", address, fd);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&storage), size) < 0) return fail("connect", address, fd);
+    setNoDelay(fd);  // 방향키 한 바이트씩을 모아 보내지 않게 한다
+    if (!setNonBlocking(fd)) return fail("fcntl", address, fd);
+    return fd;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+
+// 서버/클라이언트 주소: 숫자만 있으면 127.0.0.1의 TCP 포트, 아니면 유닉스 도메인 소켓 경로.
+// 실패하면 -1을 돌려주고 이유를 stderr에 쓴다. 돌려준 소켓은 논블로킹이다.
+int listenOn(const std::string& address);
+int connectTo(const std::string& address);
+bool setNonBlocking(int fd);
+bool isTcpAddress(const std::string& address);
+// 유닉스 도메인 소켓 파일을 지운다. 그 경로에 소켓이 아닌 파일이 있으면 건드리지 않는다
+void removeSocketFile(const std::string& address);
+// 작은 메시지를 모아 보내지 않게 한다 (TCP가 아니면 아무 일도 없다)
+void setNoDelay(int fd);
@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// 생산자 하나, 소비자 하나용 잠금 없는 고정 크기 큐.
+// push는 생산자 스레드에서만, pop은 소비자 스레드에서만 불러야 한다.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity)
+            return false;  // 가득 참
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;  // 비어 있음
+        out = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<std::size_t> head{0};  // 소비자가 다음에 읽을 위치
+    alignas(64) std::atomic<std::size_t> tail{0};  // 생산자가 다음에 쓸 위치
+};
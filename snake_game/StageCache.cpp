@@ -0,0 +1,21 @@
+#include "StageCache.h"
+#include "StageFile.h"
+
+// 실행 파일에 내장된 스테이지는 파일을 읽지 않고 쓰고, 나머지만 디스크에서 읽는다
+StageCache::StageCache(int stageCount, int arenaHeight, int arenaWidth)
+    : stages(stageCount), stageCount(stageCount) {
+    // 경기장은 스테이지마다 같으므로 하나만 만든다
+    if (arenaHeight > 0) {
+        stages.resize(1);
+        stages[0].createArena(arenaHeight, arenaWidth);
+        return;
+    }
+    for (int s = 1; s <= stageCount; ++s) {
+        if (const EmbeddedStage* embedded = findEmbeddedStage(s))
+            stages[s - 1].loadEmbedded(*embedded);
+        else
+            stages[s - 1].loadStage(s);
+        if (stages[s - 1].getHeight() == 0 && failedStage == 0)
+            failedStage = s;
+    }
+}
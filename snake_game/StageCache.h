@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include "Map.h"
+
+// 시작할 때 스테이지를 한 번만 읽어 두는 읽기 전용 템플릿 모음.
+// 게임을 다시 시작하거나 스테이지를 넘길 때는 Map::loadFrom으로 복사만 한다.
+// 불러온 뒤에는 바뀌지 않으므로 여러 스레드의 Game이 같이 써도 된다.
+class StageCache {
+public:
+    // stage1 ~ stageN. arenaHeight가 0보다 크면 파일 대신 그 크기의 빈 경기장 N개
+    explicit StageCache(int stageCount, int arenaHeight = 0, int arenaWidth = 0);
+
+    int getStageCount() const { return stageCount; }
+    // 읽지 못한(빈 맵으로 남은) 첫 스테이지 번호. 모두 읽었으면 0
+    int getFailedStage() const { return failedStage; }
+    const Map& getStage(int stage) const { return stages[stages.size() == 1 ? 0 : stage - 1]; }
+
+private:
+    std::vector<Map> stages;  // 경기장이면 모든 스테이지가 같이 쓰는 하나
+    int stageCount;
+    int failedStage = 0;
+};
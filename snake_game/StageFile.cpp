@@ -0,0 +1,137 @@
+#include "StageFile.h"
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace {
+// 파일은 행 폭을 width+2로 쓴다 (Map의 행 폭은 2의 거듭제곱이라 더 넓을 수 있다)
+int fileIndex(const Map& map, int idx) {
+    return (map.rowOf(idx) + 1) * (map.getWidth() + 2) + map.colOf(idx) + 1;
+}
+
+void storeLe16(unsigned char* p, unsigned value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+}
+
+void storeLe32(unsigned char* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) p[i] = (value >> (8 * i)) & 0xFF;
+}
+
+unsigned loadLe16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+}
+
+void encodeStageHeader(const StageFileHeader& header, unsigned char* out) {
+    std::memcpy(out, header.magic, 4);
+    storeLe16(out + 4, header.version);
+    storeLe16(out + 6, header.height);
+    storeLe16(out + 8, header.width);
+    storeLe16(out + 10, uint16_t(header.spawnY));
+    storeLe16(out + 12, uint16_t(header.spawnX));
+    storeLe16(out + 14, header.gatePairs);
+    storeLe32(out + 16, header.candidateCount);
+    storeLe32(out + 20, header.candidatesOffset);
+    storeLe32(out + 24, header.cellsOffset);
+}
+
+StageFileHeader decodeStageHeader(const unsigned char* in) {
+    StageFileHeader header;
+    std::memcpy(header.magic, in, 4);
+    header.version = loadLe16(in + 4);
+    header.height = loadLe16(in + 6);
+    header.width = loadLe16(in + 8);
+    header.spawnY = int16_t(loadLe16(in + 10));
+    header.spawnX = int16_t(loadLe16(in + 12));
+    header.gatePairs = loadLe16(in + 14);
+    header.candidateCount = loadLe32(in + 16);
+    header.candidatesOffset = loadLe32(in + 20);
+    header.cellsOffset = loadLe32(in + 24);
+    return header;
+}
+
+bool saveStageFile(const std::string& path, const Map& map) {
+    const std::vector<int>& candidates = map.getGateCandidates();
+
+    StageFileHeader header;
+    std::memcpy(header.magic, kStageFileMagic, sizeof(header.magic));
+    header.version = kStageFileVersion;
+    header.height = map.getHeight();
+    header.width = map.getWidth();
+    header.spawnY = map.getSpawnY();
+    header.spawnX = map.getSpawnX();
+    header.gatePairs = map.getGatePairs();
+    header.candidateCount = candidates.size();
+    header.candidatesOffset = kStageHeaderSize;
+    header.cellsOffset = kStageHeaderSize + candidates.size() * sizeof(uint32_t);
+    int fileStride = map.getWidth() + 2;
+
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout.is_open())
+        return false;
+
+    unsigned char bytes[kStageHeaderSize];
+    encodeStageHeader(header, bytes);
+    fout.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    for (int idx : candidates) {
+        storeLe32(bytes, fileIndex(map, idx));
+        fout.write(reinterpret_cast<const char*>(bytes), sizeof(uint32_t));
+    }
+    std::vector<char> row(fileStride);
+    for (int y = -1; y <= map.getHeight(); ++y) {
+        for (int x = -1; x <= map.getWidth(); ++x)
+            row[x + 1] = map.at(map.index(y, x));
+        fout.write(row.data(), fileStride);
+    }
+    return fout.good();
+}
+
+bool saveEmbeddedStages(const std::string& path, const std::vector<Map>& maps) {
+    std::ofstream fout(path);
+    if (!fout.is_open())
+        return false;
+
+    fout << "// stageconv -c로 만든 파일이다. 직접 고치지 말고 stageN.txt를 고친 뒤 make를 다시 돌린다.\n"
+         << "#pragma once\n"
+         << "#include \"StageFile.h\"\n\n"
+         << "namespace {\n\n";
+
+    for (size_t s = 0; s < maps.size(); ++s) {
+        const Map& map = maps[s];
+        std::string name = "kStage" + std::to_string(s + 1);
+        fout << "constexpr unsigned char " << name << "Cells[" << map.getHeight() + 2
+             << " * " << map.getWidth() + 2 << "] = {\n";
+        for (int y = -1; y <= map.getHeight(); ++y) {
+            fout << "    ";
+            for (int x = -1; x <= map.getWidth(); ++x)
+                fout << int(map.at(map.index(y, x))) << ",";
+            fout << "\n";
+        }
+        fout << "};\n";
+
+        const std::vector<int>& candidates = map.getGateCandidates();
+        if (!candidates.empty()) {
+            fout << "constexpr int " << name << "Candidates[" << candidates.size() << "] = {";
+            for (size_t i = 0; i < candidates.size(); ++i)
+                fout << (i % 16 == 0 ? "\n    " : " ") << fileIndex(map, candidates[i]) << ",";
+            fout << "\n};\n";
+        }
+        fout << "\n";
+    }
+
+    fout << "constexpr EmbeddedStage kEmbeddedStages[] = {\n";
+    for (size_t s = 0; s < maps.size(); ++s) {
+        const Map& map = maps[s];
+        std::string name = "kStage" + std::to_string(s + 1);
+        bool hasCandidates = !map.getGateCandidates().empty();
+        fout << "    {" << map.getHeight() << ", " << map.getWidth() << ", "
+             << map.getSpawnY() << ", " << map.getSpawnX() << ", " << map.getGatePairs() << ", "
+             << name << "Cells, " << (hasCandidates ? name + "Candidates" : "nullptr") << ", "
+             << map.getGateCandidates().size() << "},\n";
+    }
+    fout << "};\n\n"
+         << "constexpr int kEmbeddedStageCount = " << maps.size() << ";\n\n"
+         << "} // namespace\n";
+    return fout.good();
+}
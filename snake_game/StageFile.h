@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Map.h"
+
+// 미리 변환해 둔 바이너리 스테이지 파일 (stageN.stg).
+//
+//   StageFileHeader (kStageHeaderSize 바이트, 아래 순서대로)
+//   uint32_t candidates[candidateCount]        게이트를 놓을 수 있는 벽 칸 (아래 격자의 인덱스)
+//   uint8_t  cells[(height + 2) * (width + 2)]  WALL 테두리를 포함한 격자, 행 폭 width + 2
+//
+// 읽을 때 격자는 파싱 없이 행 단위로 Map에 옮긴다. 정수는 모두 리틀 엔디언이고,
+// 헤더와 후보 칸은 구조체를 그대로 쓰지 않고 필드마다 바이트로 풀어 쓴다.
+struct StageFileHeader {
+    char magic[4];            // "SNKS"
+    uint16_t version;
+    uint16_t height;
+    uint16_t width;
+    int16_t spawnY;
+    int16_t spawnX;
+    uint16_t gatePairs;
+    uint32_t candidateCount;
+    uint32_t candidatesOffset;
+    uint32_t cellsOffset;
+};
+
+const char kStageFileMagic[4] = {'S', 'N', 'K', 'S'};
+const uint16_t kStageFileVersion = 1;
+const std::size_t kStageHeaderSize = 28;
+
+void encodeStageHeader(const StageFileHeader& header, unsigned char* out);
+StageFileHeader decodeStageHeader(const unsigned char* in);
+inline uint32_t loadLe32(const unsigned char* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+// 현재 맵 상태를 바이너리 스테이지로 저장한다 (변환기에서 쓴다)
+bool saveStageFile(const std::string& path, const Map& map);
+
+// 빌드할 때 stageconv -c로 만들어 실행 파일에 넣은 스테이지 (EmbeddedStageData.h).
+// cells와 candidates는 .stg 파일과 같은 행 폭 width+2 배치다.
+struct EmbeddedStage {
+    int height;
+    int width;
+    int spawnY;
+    int spawnX;
+    int gatePairs;
+    const unsigned char* cells;
+    const int* candidates;
+    int candidateCount;
+};
+
+// 내장된 stageN. 없으면 nullptr
+const EmbeddedStage* findEmbeddedStage(int stage);
+
+// stageconv -c: 여러 맵을 constexpr 배열 헤더로 저장한다
+bool saveEmbeddedStages(const std::string& path, const std::vector<Map>& maps);
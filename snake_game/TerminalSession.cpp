@@ -0,0 +1,236 @@
+#include "TerminalSession.h"
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::size_t kMaxPendingBytes = 256 * 1024;  // 이만큼 못 받아 가면 끊는다
+const int kReadChunk = 256;
+const int kArrowKey = 0x100;  // 방향키는 kArrowKey + Direction으로 넘긴다
+
+} // namespace
+
+TerminalSession::TerminalSession(int fd, const GameConfig& config,
+                                 std::shared_ptr<const StageCache> stages, int tickMs,
+                                 uint64_t seed, int rows, int cols)
+    : fd(fd), game(config, std::move(stages)), canvas(rows, cols), renderer(canvas),
+      tickMs(tickMs), seed(seed) {
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0) std::perror("timerfd_create");
+}
+
+TerminalSession::~TerminalSession() {
+    if (fd >= 0) ::close(fd);
+    if (timerFd >= 0) ::close(timerFd);
+}
+
+void TerminalSession::start() {
+    canvas.begin();
+    game.reset(seed++);
+    showStageIntro();
+}
+
+// 받은 바이트를 키로 바꾼다. 방향키는 여러 번에 나눠 올 수 있어서 상태를 남겨 둔다.
+void TerminalSession::onReadable() {
+    unsigned char buffer[kReadChunk];
+    while (isOpen()) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            close();
+            return;
+        }
+        if (n < 0) return;
+
+        for (ssize_t i = 0; i < n && isOpen(); ++i) {
+            unsigned char c = buffer[i];
+            switch (escape) {
+                case ESC_NONE:
+                    if (c == 0x1b)
+                        escape = ESC_START;
+                    else
+                        onKey(c);
+                    break;
+                case ESC_START:
+                    // ESC [ A 또는 (애플리케이션 커서 모드) ESC O A
+                    escape = (c == '[' || c == 'O') ? ESC_SEQUENCE : ESC_NONE;
+                    break;
+                case ESC_SEQUENCE:
+                    if (c >= 0x40 && c <= 0x7e) {  // 마지막 바이트
+                        escape = ESC_NONE;
+                        switch (c) {
+                            case 'A': onKey(kArrowKey + UP); break;
+                            case 'B': onKey(kArrowKey + DOWN); break;
+                            case 'C': onKey(kArrowKey + RIGHT); break;
+                            case 'D': onKey(kArrowKey + LEFT); break;
+                            default:  break;
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+void TerminalSession::onKey(int key) {
+    if (key == 'q' || key == 'Q' || key == 0x03) {  // Ctrl+C도 raw 모드에서는 바이트로 온다
+        close();
+        return;
+    }
+    switch (state) {
+        case STATE_PLAYING:
+            if (key >= kArrowKey && key <= kArrowKey + RIGHT)
+                turns.push(static_cast<Direction>(key - kArrowKey), game.getSnake().getDirection(),
+                           Clock::now());
+            break;
+        case STATE_CONTINUE:
+            if (key == 'Y' || key == 'y') {
+                say(17, "Loading next stage...");
+                state = STATE_LOADING;
+                arm(1000, 0);
+            }
+            break;
+        case STATE_RESTART:
+            if (key == 'Y' || key == 'y') {
+                game.reset(seed++);
+                showStageIntro();
+            } else if (key == 'N' || key == 'n') {
+                close();
+            }
+            break;
+        default:
+            break;
+    }
+    send();
+}
+
+void TerminalSession::onTimer() {
+    uint64_t expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return;
+
+    switch (state) {
+        case STATE_INTRO:
+            // 안내 문구를 지우도록 첫 프레임은 전체를 다시 그린다
+            renderer.invalidate();
+            turns.clear();
+            state = STATE_PLAYING;
+            arm(tickMs, tickMs);
+            step();
+            break;
+        case STATE_PLAYING:
+            // 밀린 틱은 몰아서 돌리지 않는다
+            stats.overruns += expirations - 1;
+            step();
+            break;
+        case STATE_MESSAGE:
+            askRestart();
+            break;
+        case STATE_LOADING:
+            showStageIntro();
+            break;
+        default:
+            break;
+    }
+    send();
+}
+
+void TerminalSession::step() {
+    auto start = Clock::now();
+    TurnQueue::Turn turn;
+    Direction current = game.getSnake().getDirection();
+    Direction action = turns.popValid(current, turn) ? turn.dir : current;
+    StepEvents events = game.step(action);
+    ++stats.ticks;
+
+    // 스테이지를 넘기는 틱은 이전 프레임 위에 안내 문구를 띄운다
+    if (!events.stageCleared)
+        renderer.draw(game);
+
+    if (events.gameOver == OVER_MAX_LENGTH) {
+        say(18, "Max length reached! Game Over!");
+        state = STATE_MESSAGE;
+        arm(2000, 0);
+    } else if (events.gameOver == OVER_ALL_CLEARED) {
+        say(16, "All stages cleared! Congrats!");
+        state = STATE_MESSAGE;
+        arm(3000, 0);
+    } else if (events.gameOver != OVER_NONE) {
+        askRestart();
+    } else if (events.stageCleared) {
+        // 엔진은 이미 다음 스테이지를 불러왔고, 화면에는 아직 이전 프레임이 남아 있다
+        say(16, "Mission Completed! Press 'Y' to continue.");
+        state = STATE_CONTINUE;
+        arm(0, 0);
+    }
+    stats.frameNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+void TerminalSession::showStageIntro() {
+    renderer.invalidate();
+    renderer.draw(game);
+    say(15, "Stage %d 2 seconds later start...", game.getStage());
+    state = STATE_INTRO;
+    arm(2000, 0);
+}
+
+void TerminalSession::askRestart() {
+    canvas.clear();
+    canvas.put(10, 10, "Game over! Restart? (Y/N)");
+    renderer.invalidate();
+    state = STATE_RESTART;
+    arm(0, 0);
+}
+
+void TerminalSession::say(int row, const char* format, ...) {
+    char text[96];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    canvas.put(row, renderer.getPanelX(), text);
+}
+
+// delayMs 뒤에 한 번, periodMs가 0보다 크면 그 뒤로 periodMs마다. delayMs가 0이면 멈춘다.
+void TerminalSession::arm(int delayMs, int periodMs) {
+    itimerspec spec = {};
+    spec.it_value.tv_sec = delayMs / 1000;
+    spec.it_value.tv_nsec = long(delayMs % 1000) * 1000000;
+    spec.it_interval.tv_sec = periodMs / 1000;
+    spec.it_interval.tv_nsec = long(periodMs % 1000) * 1000000;
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+}
+
+// 그린 만큼 보내고 못 보낸 나머지는 캔버스 버퍼에 남긴다 (다음 프레임은 그 뒤에 이어 쓴다)
+void TerminalSession::send() {
+    std::size_t sent = 0;
+    while (isOpen() && sent < canvas.size()) {
+        ssize_t n = ::send(fd, canvas.data() + sent, canvas.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) close();
+            break;
+        }
+        sent += n;
+    }
+    stats.bytesOut += sent;
+    canvas.consume(sent);
+    if (canvas.size() > kMaxPendingBytes) close();
+}
+
+// 터미널을 원래대로 돌려주고 닫는다. 끝 인사가 다 안 나가도 기다리지 않는다.
+void TerminalSession::close() {
+    if (fd < 0) return;
+    canvas.consume(canvas.size());
+    canvas.end();
+    ::send(fd, canvas.data(), canvas.size(), MSG_NOSIGNAL);
+    canvas.consume(canvas.size());
+    ::close(fd);
+    fd = -1;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "AnsiCanvas.h"
+#include "Game.h"
+#include "Renderer.h"
+#include "TurnQueue.h"
+
+// 한 사람 몫의 게임. GameManager가 ncurses로 하던 흐름(스테이지 안내, 틱, 미션 완료, 다시 하기)을
+// sleep과 입력 대기 없이 상태로 나눠서, 소켓/pty 하나와 timerfd 하나로 돌린다.
+// 화면은 자기 AnsiCanvas 버퍼에 그려서 그 fd로 보낸다. 여러 세션이 한 스레드에서 번갈아 돈다.
+// 입력은 터미널이 raw 모드로 보내는 바이트 그대로다 (방향키 ESC [ A~D, y/n, q).
+struct SessionStats {
+    long ticks = 0;
+    long overruns = 0;    // 틱을 처리하러 왔을 때 이미 다음 틱까지 지나 있던 횟수
+    long bytesOut = 0;
+    double frameNs = 0;   // step + 그리기 시간 합
+
+    SessionStats& operator+=(const SessionStats& other) {
+        ticks += other.ticks;
+        overruns += other.overruns;
+        bytesOut += other.bytesOut;
+        frameNs += other.frameNs;
+        return *this;
+    }
+};
+
+class TerminalSession {
+public:
+    // fd는 논블로킹이어야 하고 세션이 닫는다
+    TerminalSession(int fd, const GameConfig& config, std::shared_ptr<const StageCache> stages,
+                    int tickMs, uint64_t seed, int rows, int cols);
+    ~TerminalSession();
+    TerminalSession(const TerminalSession&) = delete;
+    TerminalSession& operator=(const TerminalSession&) = delete;
+
+    bool isOpen() const { return timerFd >= 0 && fd >= 0; }  // 타이머를 못 만들었거나 끝났으면 false
+    int getFd() const { return fd; }
+    int getTimerFd() const { return timerFd; }
+    bool wantsWrite() const { return canvas.size() > 0; }  // 못 보낸 프레임이 남아 있다
+    const SessionStats& getStats() const { return stats; }
+
+    void start();
+    void onReadable();
+    void onWritable() { send(); }
+    void onTimer();
+
+private:
+    enum State {
+        STATE_INTRO,     // 스테이지 안내 (타이머가 끝나면 시작)
+        STATE_PLAYING,
+        STATE_MESSAGE,   // 끝난 이유를 보여 주는 중 (타이머가 끝나면 다시 할지 묻는다)
+        STATE_CONTINUE,  // 미션 완료, Y를 기다린다
+        STATE_LOADING,   // 다음 스테이지 안내 전
+        STATE_RESTART    // 다시 할지 묻는 중 (Y/N)
+    };
+    enum EscapeState { ESC_NONE, ESC_START, ESC_SEQUENCE };
+
+    int fd;
+    int timerFd = -1;
+    Game game;
+    AnsiCanvas canvas;
+    Renderer renderer;
+    TurnQueue turns;
+    int tickMs;
+    uint64_t seed;
+    State state = STATE_INTRO;
+    EscapeState escape = ESC_NONE;
+    SessionStats stats;
+
+    void step();
+    void onKey(int key);
+    void showStageIntro();
+    void askRestart();
+    void say(int row, const char* format, ...);
+    void arm(int delayMs, int periodMs);
+    void send();
+    void close();
+};
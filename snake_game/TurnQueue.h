@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include "Snake.h"
+
+// 한 틱에 하나씩 적용할 방향 전환 대기열.
+// 빠르게 연달아 누른 방향키(예: 위 -> 왼쪽)를 틱 하나에 뭉개지 않고 차례로 적용한다.
+// 새 방향은 그때 적용될 방향(마지막으로 쌓인 방향, 없으면 현재 방향)과 비교해서
+// 같거나 반대면 버린다. 쌓인 뒤에 게이트가 진행 방향을 바꿀 수 있으므로 꺼낼 때도 popValid로 다시 본다.
+class TurnQueue {
+public:
+    static const int kCapacity = 3;
+
+    struct Turn {
+        Direction dir;
+        std::chrono::steady_clock::time_point time;  // 키를 읽은 시각
+    };
+
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    bool push(Direction dir, Direction current, std::chrono::steady_clock::time_point time) {
+        Direction effective = count > 0 ? turns[count - 1].dir : current;
+        if (count == kCapacity || dir == effective || isReverse(dir, effective))
+            return false;
+        turns[count++] = {dir, time};
+        return true;
+    }
+
+    bool pop(Turn& turn) {
+        if (count == 0) return false;
+        turn = turns[0];
+        for (int i = 1; i < count; ++i)
+            turns[i - 1] = turns[i];
+        --count;
+        return true;
+    }
+
+    // 현재 방향과 같거나 반대인 전환은 버리고 적용할 수 있는 첫 전환을 꺼낸다
+    bool popValid(Direction current, Turn& turn) {
+        while (pop(turn)) {
+            if (turn.dir != current && !isReverse(turn.dir, current))
+                return true;
+        }
+        return false;
+    }
+
+    static bool isReverse(Direction a, Direction b) {
+        return (a == UP && b == DOWN) || (a == DOWN && b == UP) ||
+               (a == LEFT && b == RIGHT) || (a == RIGHT && b == LEFT);
+    }
+
+private:
+    Turn turns[kCapacity];
+    int count = 0;
+};
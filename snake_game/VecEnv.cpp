@@ -0,0 +1,301 @@
+#include "VecEnv.h"
+#include "Snake.h"
+#include "StageCache.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+const int kItemTries = 64;  // 무작위로 빈 칸을 찾는 횟수, 넘으면 순서대로 훑는다
+}
+
+VecEnv::VecEnv(int numEnvs, const GameConfig& config, uint64_t seed)
+    : config(config), numEnvs(numEnvs) {
+    // 스테이지는 한 번만 읽어서 템플릿으로 들고 있고, 시작할 때마다 복사한다
+    StageCache cache(config.stageCount, config.arenaHeight, config.arenaWidth);
+    for (int s = 1; s <= config.stageCount; ++s) {
+        const Map& map = cache.getStage(s);
+        if (map.getCellCount() == 0)
+            throw std::runtime_error("VecEnv: failed to load stage " + std::to_string(s));
+        // 환경마다 격자를 따로 들고 있으므로 Map보다 촘촘한 행 폭 width+2로 옮겨 담는다
+        int rowStride = map.getWidth() + 2;
+        int cellCount = (map.getHeight() + 2) * rowStride;
+        if (stride == 0) {
+            stride = rowStride;
+            area = cellCount;
+        } else if (rowStride != stride || cellCount != area) {
+            throw std::runtime_error("VecEnv: all stages must have the same size");
+        }
+        auto toLocal = [&](int idx) { return (map.rowOf(idx) + 1) * stride + map.colOf(idx) + 1; };
+        StageTemplate stageTemplate;
+        stageTemplate.cells.resize(area);
+        for (int y = -1; y <= map.getHeight(); ++y) {
+            for (int x = -1; x <= map.getWidth(); ++x) {
+                // Game::startStage처럼 스테이지에 그려진 아이템은 지우고 시작한다
+                CellType value = map.at(map.index(y, x));
+                if (value == GROWTH_ITEM || value == POISON_ITEM) value = EMPTY;
+                stageTemplate.cells[(y + 1) * stride + x + 1] = value;
+            }
+        }
+        for (int idx : map.getGateCandidates())
+            stageTemplate.walls.push_back(toLocal(idx));
+        stageTemplate.spawn = toLocal(map.index(map.getSpawnY(), map.getSpawnX()));
+        stageTemplate.gatePairs = map.getGatePairs();
+        stages.push_back(std::move(stageTemplate));
+    }
+
+    if (long(numEnvs) * area > kMaxCells)
+        throw std::runtime_error("VecEnv: " + std::to_string(numEnvs) + " envs of " +
+                                 std::to_string(area) + " cells is too large");
+
+    // 길이가 maxLength에 닿으면 끝나므로 몸통은 그보다 길어지지 않는다
+    int capacity = 1;
+    while (capacity < config.maxLength + 1) capacity <<= 1;
+    bodyMask = capacity - 1;
+
+    cells.resize(size_t(numEnvs) * area);
+    occupancy.resize(size_t(numEnvs) * area);
+    body.resize(size_t(numEnvs) * capacity);
+    itemCell.assign(size_t(numEnvs) * 2, -1);
+    head.resize(numEnvs);
+    headSlot.resize(numEnvs);
+    length.resize(numEnvs);
+    direction.resize(numEnvs);
+    stage.resize(numEnvs);
+    tick.resize(numEnvs);
+    growthCount.resize(numEnvs);
+    poisonCount.resize(numEnvs);
+    gateUseCount.resize(numEnvs);
+    lastGrowthItemTick.resize(numEnvs);
+    lastPoisonItemTick.resize(numEnvs);
+    gates.resize(numEnvs);
+    target.resize(numEnvs);
+    reversed.resize(numEnvs);
+    moveResult.resize(numEnvs);
+    gameOver.resize(numEnvs);
+    episodeTicks.resize(numEnvs);
+    episodeStages.resize(numEnvs);
+
+    rng.reserve(numEnvs);
+    for (int i = 0; i < numEnvs; ++i)
+        rng.emplace_back(seed + 0x9E3779B97F4A7C15ULL * (i + 1));
+
+    reset();
+}
+
+void VecEnv::reset() {
+    for (int env = 0; env < numEnvs; ++env)
+        resetEnv(env);
+}
+
+void VecEnv::resetEnv(int env) {
+    tick[env] = 0;
+    startStage(env, config.startStage);
+}
+
+void VecEnv::startStage(int env, int newStage) {
+    stage[env] = newStage;
+    std::memcpy(&cells[size_t(env) * area], stages[newStage - 1].cells.data(), area);
+    std::memset(&occupancy[size_t(env) * area], 0, area);
+
+    // Snake::init과 같은 오른쪽 방향 3칸
+    unsigned char* occ = &occupancy[size_t(env) * area];
+    int* ring = &body[size_t(env) * (bodyMask + 1)];
+    int spawn = stages[newStage - 1].spawn;
+    for (int i = 0; i < 3; ++i) {
+        ring[i] = spawn - i;
+        occ[spawn - i] = 1;
+    }
+    head[env] = spawn;
+    headSlot[env] = 0;
+    length[env] = 3;
+    direction[env] = RIGHT;
+
+    growthCount[env] = 0;
+    poisonCount[env] = 0;
+    gateUseCount[env] = 0;
+    lastGrowthItemTick[env] = tick[env];
+    lastPoisonItemTick[env] = tick[env];
+
+    addItem(env, GROWTH_ITEM);
+    addItem(env, POISON_ITEM);
+
+    // Game::generateGates와 같은 방식으로 게이트 쌍을 고른다.
+    // 스테이지 안에서는 아이템만 빈 칸과 바뀌므로 게이트 옆 칸의 통행 여부가 그대로다.
+    // 출구 표는 여기서 한 번만 만든다.
+    const StageTemplate& stageTemplate = stages[newStage - 1];
+    GateTable::pickGates(stageTemplate.walls, stageTemplate.gatePairs, rng[env], gateCells);
+    for (int idx : gateCells)
+        cells[size_t(env) * area + idx] = GATE;
+    gates[env].build(&cells[size_t(env) * area], stride, gateCells);
+}
+
+void VecEnv::addItem(int env, CellType item) {
+    CellType* grid = &cells[size_t(env) * area];
+    const unsigned char* occ = &occupancy[size_t(env) * area];
+    int& placed = itemCellOf(env, item);
+    placed = -1;
+    for (int tries = 0; tries < kItemTries; ++tries) {
+        int idx = rng[env].below(area);
+        if (grid[idx] == EMPTY && !occ[idx]) {
+            grid[idx] = item;
+            placed = idx;
+            return;
+        }
+    }
+    // 맵이 거의 찬 경우: 빈 칸 중 하나를 순서대로 골라서 놓는다
+    int freeCount = 0;
+    for (int idx = 0; idx < area; ++idx)
+        freeCount += grid[idx] == EMPTY && !occ[idx];
+    if (freeCount == 0) return;
+    int pick = rng[env].below(freeCount);
+    for (int idx = 0; idx < area; ++idx) {
+        if (grid[idx] == EMPTY && !occ[idx] && pick-- == 0) {
+            grid[idx] = item;
+            placed = idx;
+            return;
+        }
+    }
+}
+
+// 아이템은 종류마다 하나뿐이라 addItem이 적어 둔 칸만 지운다 (먹힌 뒤면 이미 EMPTY다)
+void VecEnv::clearItem(int env, CellType item) {
+    int& placed = itemCellOf(env, item);
+    CellType* grid = &cells[size_t(env) * area];
+    if (placed >= 0 && grid[placed] == item)
+        grid[placed] = EMPTY;
+    placed = -1;
+}
+
+void VecEnv::popTail(int env) {
+    int slot = (headSlot[env] + length[env] - 1) & bodyMask;
+    occupancy[size_t(env) * area + body[size_t(env) * (bodyMask + 1) + slot]] = 0;
+    --length[env];
+}
+
+void VecEnv::step(const unsigned char* actions) {
+    const int n = numEnvs;
+    const int rowStep = stride;
+    unsigned char* dir = direction.data();
+    unsigned char* rev = reversed.data();
+    const int* headCell = head.data();
+    int* next = target.data();
+
+    // 1단계: 방향 갱신과 다음 칸 계산 (분기 없음, 게임 축으로 벡터화)
+    // UP=0, DOWN=1, LEFT=2, RIGHT=3 이라서 반대 방향끼리는 xor 값이 1이다.
+    for (int i = 0; i < n; ++i) {
+        unsigned char a = actions[i];
+        unsigned char d = dir[i];
+        unsigned char isReverse = (a ^ d) == 1;
+        unsigned char nd = isReverse ? d : a;
+        int step = (nd < 2 ? rowStep : 1) * ((nd & 1) ? 1 : -1);
+        rev[i] = isReverse;
+        dir[i] = nd;
+        next[i] = headCell[i] + step;
+    }
+
+    // 2단계: 게임별 충돌/아이템/게이트 처리
+    for (int i = 0; i < n; ++i) {
+        int reason = rev[i] ? OVER_REVERSE : resolve(i);
+        gameOver[i] = reason;
+        if (reason != OVER_NONE) {
+            episodeTicks[i] = tick[i];
+            episodeStages[i] = stage[i];
+            resetEnv(i);
+        }
+    }
+}
+
+int VecEnv::resolve(int env) {
+    CellType* grid = &cells[size_t(env) * area];
+    unsigned char* occ = &occupancy[size_t(env) * area];
+    int* ring = &body[size_t(env) * (bodyMask + 1)];
+
+    int newIdx = target[env];
+    int cell = grid[newIdx];
+    bool usedGate = false;
+
+    if (cell == GATE) {
+        const GateTable::Exit* exit = gates[env].lookup(newIdx, static_cast<Direction>(direction[env]));
+        if (!exit) {
+            moveResult[env] = Snake::MOVE_DEAD;  // 짝이 없는 게이트 칸은 벽이다
+            return OVER_COLLISION;
+        }
+        newIdx = exit->cell;
+        direction[env] = exit->dir;
+        usedGate = true;
+    }
+
+    if (occ[newIdx] || grid[newIdx] == WALL || grid[newIdx] == IMMUNE_WALL) {
+        moveResult[env] = Snake::MOVE_DEAD;
+        return OVER_COLLISION;
+    }
+
+    headSlot[env] = (headSlot[env] - 1) & bodyMask;
+    ring[headSlot[env]] = newIdx;
+    head[env] = newIdx;
+    occ[newIdx] = 1;
+    ++length[env];
+
+    Snake::MoveResult result = usedGate ? Snake::MOVE_GATE : Snake::MOVE_NORMAL;
+    if (cell == GROWTH_ITEM) {
+        grid[newIdx] = EMPTY;
+        result = Snake::MOVE_GROWTH;
+    } else if (cell == POISON_ITEM) {
+        grid[newIdx] = EMPTY;
+        if (length[env] > 1) popTail(env);
+        if (length[env] > 1) popTail(env);
+        result = Snake::MOVE_POISON;
+    } else {
+        popTail(env);
+    }
+
+    if (length[env] < 3) {
+        moveResult[env] = Snake::MOVE_DEAD;
+        return OVER_COLLISION;
+    }
+    moveResult[env] = result;
+
+    switch (result) {
+        case Snake::MOVE_GROWTH:
+            growthCount[env]++;
+            lastGrowthItemTick[env] = tick[env];
+            addItem(env, GROWTH_ITEM);
+            break;
+        case Snake::MOVE_POISON:
+            poisonCount[env]++;
+            lastPoisonItemTick[env] = tick[env];
+            addItem(env, POISON_ITEM);
+            break;
+        case Snake::MOVE_GATE:
+            gateUseCount[env]++;
+            break;
+        default:
+            break;
+    }
+
+    if (length[env] >= config.maxLength)
+        return OVER_MAX_LENGTH;
+
+    if (growthCount[env] >= 3 && poisonCount[env] >= 2 && gateUseCount[env] >= 1) {
+        if (stage[env] >= config.stageCount)
+            return OVER_ALL_CLEARED;
+        startStage(env, stage[env] + 1);
+    }
+
+    long now = ++tick[env];
+
+    if (now - lastGrowthItemTick[env] >= config.itemLifetimeTicks) {
+        clearItem(env, GROWTH_ITEM);
+        addItem(env, GROWTH_ITEM);
+        lastGrowthItemTick[env] = now;
+    }
+
+    if (now - lastPoisonItemTick[env] >= config.itemLifetimeTicks) {
+        clearItem(env, POISON_ITEM);
+        addItem(env, POISON_ITEM);
+        lastPoisonItemTick[env] = now;
+    }
+
+    return OVER_NONE;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Game.h"
+#include "GateTable.h"
+#include "Rng.h"
+
+// 여러 게임을 한 틱씩 같이 진행하는 배치 환경 (강화학습용).
+// 게임별 상태를 구조체 배열(SoA)로 들고 있어서 방향/다음 칸 계산은 게임 축으로 벡터화된다.
+// 규칙은 Game::step과 같고, 끝난 게임은 step 안에서 바로 첫 스테이지로 다시 시작한다.
+class VecEnv {
+public:
+    // 모든 게임의 격자 칸 수 합이 이보다 크면 만들지 않는다 (칸마다 셀과 점유 2바이트)
+    static constexpr long kMaxCells = 1L << 30;
+
+    VecEnv(int numEnvs, const GameConfig& config, uint64_t seed);
+
+    void reset();                             // 모든 게임을 새로 시작
+    void step(const unsigned char* actions);  // actions[i]는 i번 게임의 Direction
+
+    int size() const { return numEnvs; }
+    int getStride() const { return stride; }
+    int getCellCount() const { return area; }
+
+    // 관측값. 셀 배열은 Map과 같은 테두리 포함 배치.
+    const CellType* cellsOf(int env) const { return &cells[size_t(env) * area]; }
+    const unsigned char* occupancyOf(int env) const { return &occupancy[size_t(env) * area]; }
+    const std::vector<int>& getHeads() const { return head; }
+    const std::vector<unsigned char>& getDirections() const { return direction; }
+    const std::vector<int>& getLengths() const { return length; }
+    const std::vector<int>& getStages() const { return stage; }
+
+    // 직전 step의 결과. gameOver가 OVER_NONE이 아니면 그 게임은 이미 다시 시작된 상태다.
+    const std::vector<unsigned char>& getMoveResults() const { return moveResult; }
+    const std::vector<unsigned char>& getGameOver() const { return gameOver; }
+    const std::vector<long>& getEpisodeTicks() const { return episodeTicks; }
+    const std::vector<int>& getEpisodeStages() const { return episodeStages; }
+
+private:
+    struct StageTemplate {
+        std::vector<CellType> cells;
+        std::vector<int> walls;  // 게이트 후보
+        int spawn = 0;
+        int gatePairs = 1;
+    };
+
+    GameConfig config;
+    int numEnvs;
+    int stride = 0;
+    int area = 0;      // 게임 하나의 셀 수 (테두리 포함)
+    int bodyMask = 0;  // 몸통 링 버퍼 크기 - 1
+    std::vector<StageTemplate> stages;
+
+    // 게임별 격자
+    std::vector<CellType> cells;
+    std::vector<unsigned char> occupancy;
+    std::vector<int> body;  // 게임마다 bodyMask + 1 칸
+    std::vector<int> itemCell;  // 게임마다 [성장, 독] 아이템 칸 (없으면 -1). 만료될 때 격자를 훑지 않게
+
+    // 게임별 스칼라 상태
+    std::vector<int> head;
+    std::vector<int> headSlot;  // 머리가 들어있는 링 버퍼 슬롯
+    std::vector<int> length;
+    std::vector<unsigned char> direction;
+    std::vector<int> stage;
+    std::vector<long> tick;
+    std::vector<int> growthCount, poisonCount, gateUseCount;
+    std::vector<long> lastGrowthItemTick, lastPoisonItemTick;
+    std::vector<GateTable> gates;
+    std::vector<int> gateCells;  // startStage에서 쓰는 임시 버퍼
+    std::vector<Rng> rng;
+
+    // step 중간 결과
+    std::vector<int> target;
+    std::vector<unsigned char> reversed;
+    std::vector<unsigned char> moveResult;
+    std::vector<unsigned char> gameOver;
+    std::vector<long> episodeTicks;
+    std::vector<int> episodeStages;
+
+    void resetEnv(int env);
+    void startStage(int env, int newStage);
+    int resolve(int env);  // 이동 결과 처리, 게임 종료 사유 반환
+    void addItem(int env, CellType item);
+    void clearItem(int env, CellType item);
+    int& itemCellOf(int env, CellType item) { return itemCell[size_t(env) * 2 + (item == POISON_ITEM)]; }
+    void popTail(int env);
+};
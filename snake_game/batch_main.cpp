@@ -0,0 +1,323 @@
+// 헤드리스 배치 시뮬레이터
+// N개의 게임을 T개 워커 스레드에 나눠 봇 정책으로 끝까지 돌리고 처리량과 결과 분포를 출력한다.
+// -e 옵션을 주면 스레드마다 VecEnv 하나로 E개 게임을 같이 진행한다 (무작위 방향 전환 정책).
+// -n 옵션을 주면 게임마다 봇 뱀 N마리가 한 맵에서 겨룬다 (MultiGame).
+#include "Bot.h"
+#include "Game.h"
+#include "MultiGame.h"
+#include "StageCache.h"
+#include "VecEnv.h"
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kPoolSize = 8;  // 스레드마다 번갈아 돌리는 게임 인스턴스 수
+
+// 게임 종료 사유 + 틱 제한 초과
+enum Outcome {
+    OUTCOME_COLLISION,
+    OUTCOME_REVERSE,
+    OUTCOME_MAX_LENGTH,
+    OUTCOME_ALL_CLEARED,
+    OUTCOME_TICK_LIMIT,
+    OUTCOME_COUNT
+};
+
+const char* const kOutcomeNames[OUTCOME_COUNT] = {
+    "collision", "reverse", "max length", "all cleared", "tick limit"
+};
+
+struct BatchOptions {
+    long games = 100000;
+    int threads = 0;         // 0이면 코어 수
+    long maxTicks = 5000;    // 게임 하나당 최대 틱
+    uint64_t seed = 1;
+    int envs = 0;            // 0이 아니면 VecEnv 모드, 스레드당 게임 수
+    int arenaHeight = 0;     // 0이 아니면 스테이지 파일 대신 빈 경기장
+    int arenaWidth = 0;
+    int snakes = 0;          // 0이 아니면 여러 뱀 모드, 게임당 뱀 수
+};
+
+struct WorkerResult {
+    long games = 0;
+    long ticks = 0;
+    long snakeTicks = 0;        // 여러 뱀 모드: 살아 있는 뱀이 움직인 횟수
+    long deaths[MultiGame::DEATH_COUNT] = {};  // 여러 뱀 모드: 죽은 이유별 (DEATH_NONE은 끝까지 산 뱀)
+    long outcomes[OUTCOME_COUNT] = {};
+    long stageReached[8] = {};  // 끝났을 때의 스테이지 (마지막 칸은 그 이상)
+};
+
+// 게임 번호로부터 시드를 만든다 (splitmix64). 스레드 수와 상관없이 같은 게임이 나온다.
+uint64_t gameSeed(uint64_t base, long gameId) {
+    uint64_t z = base + 0x9E3779B97F4A7C15ULL * (gameId + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void pinToCore(int core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+Outcome outcomeOf(GameOverReason reason) {
+    switch (reason) {
+        case OVER_REVERSE:     return OUTCOME_REVERSE;
+        case OVER_MAX_LENGTH:  return OUTCOME_MAX_LENGTH;
+        case OVER_ALL_CLEARED: return OUTCOME_ALL_CLEARED;
+        case OVER_NONE:        return OUTCOME_TICK_LIMIT;
+        default:               return OUTCOME_COLLISION;
+    }
+}
+
+// [firstGame, lastGame) 범위의 게임을 인스턴스 풀로 돌린다
+void runWorker(int core, const BatchOptions& options, long firstGame, long lastGame,
+               WorkerResult& result) {
+    pinToCore(core);
+
+    // 스테이지는 스레드마다 한 번만 읽고, 게임을 다시 시작할 때는 복사만 한다
+    GameConfig config;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    auto stages = std::make_shared<const StageCache>(config.stageCount, config.arenaHeight,
+                                                      config.arenaWidth);
+    std::vector<Game> pool(kPoolSize, Game(config, stages));
+    std::vector<bool> active(kPoolSize, false);
+    long nextGame = firstGame;
+    int running = 0;
+
+    for (int i = 0; i < kPoolSize && nextGame < lastGame; ++i) {
+        pool[i].reset(gameSeed(options.seed, nextGame++));
+        active[i] = true;
+        ++running;
+    }
+
+    while (running > 0) {
+        for (int i = 0; i < kPoolSize; ++i) {
+            if (!active[i]) continue;
+            Game& game = pool[i];
+
+            game.step(chooseBotDirection(game));
+            ++result.ticks;
+
+            if (!game.isOver() && game.getTick() < options.maxTicks) continue;
+
+            ++result.games;
+            ++result.outcomes[outcomeOf(game.getOverReason())];
+            int stage = game.getStage() < 7 ? game.getStage() : 7;
+            ++result.stageReached[stage];
+
+            if (nextGame < lastGame) {
+                game.reset(gameSeed(options.seed, nextGame++));
+            } else {
+                active[i] = false;
+                --running;
+            }
+        }
+    }
+}
+
+// [firstGame, lastGame) 범위의 여러 뱀 게임을 하나씩 끝까지 돌린다
+void runMultiWorker(int core, const BatchOptions& options, long firstGame, long lastGame,
+                    WorkerResult& result) {
+    pinToCore(core);
+
+    MultiConfig config;
+    config.snakeCount = options.snakes;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    MultiGame match(config);
+    std::vector<Direction> actions(match.getSnakeCount());
+
+    for (long gameId = firstGame; gameId < lastGame; ++gameId) {
+        match.reset(gameSeed(options.seed, gameId));
+        while (!match.isOver() && match.getTick() < options.maxTicks) {
+            for (int id = 0; id < match.getSnakeCount(); ++id) {
+                const MultiGame::Player& player = match.getPlayer(id);
+                if (player.isAlive())
+                    actions[id] = chooseBotDirection(match.getMap(), player.snake, LIST_GROWTH);
+            }
+            result.snakeTicks += match.getAliveCount();
+            match.step(actions.data());
+            ++result.ticks;
+        }
+
+        ++result.games;
+        ++result.outcomes[match.isOver() ? OUTCOME_COLLISION : OUTCOME_TICK_LIMIT];
+        for (int id = 0; id < match.getSnakeCount(); ++id)
+            ++result.deaths[match.getPlayer(id).death];
+    }
+}
+
+// VecEnv 하나로 maxTicks 틱 동안 envs개 게임을 진행한다
+void runVecWorker(int core, const BatchOptions& options, int worker, WorkerResult& result) {
+    pinToCore(core);
+
+    GameConfig config;
+    config.arenaHeight = options.arenaHeight;
+    config.arenaWidth = options.arenaWidth;
+    VecEnv env(options.envs, config, gameSeed(options.seed, worker));
+    std::vector<unsigned char> actions(options.envs);
+    uint64_t state = gameSeed(options.seed, -1 - worker);
+
+    for (long t = 0; t < options.maxTicks; ++t) {
+        // 대부분은 직진, 1/8 확률로 반대 방향이 아닌 쪽으로 꺾는다 (xorshift64)
+        const std::vector<unsigned char>& dirs = env.getDirections();
+        for (int i = 0; i < options.envs; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            unsigned char turn = (state >> 3) & 3;
+            bool change = (state & 7) == 0 && (turn ^ dirs[i]) != 1;
+            actions[i] = change ? turn : dirs[i];
+        }
+
+        env.step(actions.data());
+        result.ticks += options.envs;
+
+        const std::vector<unsigned char>& over = env.getGameOver();
+        const std::vector<int>& stages = env.getEpisodeStages();
+        for (int i = 0; i < options.envs; ++i) {
+            if (over[i] == OVER_NONE) continue;
+            ++result.games;
+            ++result.outcomes[outcomeOf(static_cast<GameOverReason>(over[i]))];
+            ++result.stageReached[stages[i] < 7 ? stages[i] : 7];
+        }
+    }
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "usage: %s [-g games] [-t threads] [-m max_ticks] [-s seed] [-e envs] [-a HxW] [-n snakes]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BatchOptions options;
+    int opt;
+    while ((opt = getopt(argc, argv, "g:t:m:s:e:a:n:h")) != -1) {
+        switch (opt) {
+            case 'g': options.games = std::atol(optarg); break;
+            case 't': options.threads = std::atoi(optarg); break;
+            case 'm': options.maxTicks = std::atol(optarg); break;
+            case 's': options.seed = std::strtoull(optarg, nullptr, 10); break;
+            case 'e': options.envs = std::atoi(optarg); break;
+            case 'a':
+                if (std::sscanf(optarg, "%dx%d", &options.arenaHeight, &options.arenaWidth) != 2 ||
+                    options.arenaHeight < 8 || options.arenaWidth < 8 ||
+                    !Map::fitsIndex(options.arenaHeight, options.arenaWidth)) {
+                    std::fprintf(stderr, "bad arena size %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                options.snakes = std::atoi(optarg);
+                if (options.snakes < 1 || options.snakes > Map::kMaxOwners) {
+                    std::fprintf(stderr, "snakes must be 1..%d\n", Map::kMaxOwners);
+                    return 1;
+                }
+                break;
+            default:  usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (options.envs > 0 && options.snakes > 0) {
+        std::fprintf(stderr, "-e and -n cannot be used together\n");
+        return 1;
+    }
+    // 스레드마다 VecEnv가 envs개 격자를 한 번에 잡으므로 할당하기 전에 거절한다
+    if (options.envs > 0 && options.arenaHeight > 0 &&
+        long(options.envs) * (options.arenaHeight + 2) * (options.arenaWidth + 2) > VecEnv::kMaxCells) {
+        std::fprintf(stderr, "%d envs of a %dx%d arena need more than %ld cells per thread\n",
+                     options.envs, options.arenaHeight, options.arenaWidth, VecEnv::kMaxCells);
+        return 1;
+    }
+
+    int cores = std::thread::hardware_concurrency();
+    if (cores <= 0) cores = 1;
+    int threads = options.threads > 0 ? options.threads : cores;
+
+    std::vector<WorkerResult> results(threads);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        if (options.envs > 0) {
+            workers.emplace_back(runVecWorker, t % cores, std::cref(options), t,
+                                 std::ref(results[t]));
+            continue;
+        }
+        long first = options.games * t / threads;
+        long last = options.games * (t + 1) / threads;
+        if (options.snakes > 0) {
+            workers.emplace_back(runMultiWorker, t % cores, std::cref(options), first, last,
+                                 std::ref(results[t]));
+            continue;
+        }
+        workers.emplace_back(runWorker, t % cores, std::cref(options), first, last,
+                             std::ref(results[t]));
+    }
+    for (auto& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerResult total;
+    for (const auto& r : results) {
+        total.games += r.games;
+        total.ticks += r.ticks;
+        total.snakeTicks += r.snakeTicks;
+        for (int i = 0; i < MultiGame::DEATH_COUNT; ++i) total.deaths[i] += r.deaths[i];
+        for (int i = 0; i < OUTCOME_COUNT; ++i) total.outcomes[i] += r.outcomes[i];
+        for (int i = 0; i < 8; ++i) total.stageReached[i] += r.stageReached[i];
+    }
+
+    if (options.envs > 0)
+        std::printf("vecenv     %d envs x %d threads, %ld ticks\n", options.envs, threads,
+                    options.maxTicks);
+    std::printf("games      %ld (%d threads, seed %llu)\n", total.games, threads,
+                static_cast<unsigned long long>(options.seed));
+    std::printf("elapsed    %.3f s\n", seconds);
+    std::printf("games/sec  %.0f\n", total.games / seconds);
+    std::printf("ticks/sec  %.0f\n", total.ticks / seconds);
+    std::printf("ticks/game %.1f\n", total.games ? double(total.ticks) / total.games : 0.0);
+
+    if (options.snakes > 0) {
+        static const char* const kDeathNames[MultiGame::DEATH_COUNT] = {
+            "survived", "wall", "self", "other body", "head-on", "poison", "reverse", "no room"
+        };
+        long snakes = total.games * options.snakes;
+        std::printf("moves/sec  %.0f\n", total.snakeTicks / seconds);
+        std::printf("\nmatches    %ld decided, %ld tick limit\n", total.outcomes[OUTCOME_COLLISION],
+                    total.outcomes[OUTCOME_TICK_LIMIT]);
+        std::printf("\nsnakes\n");
+        for (int i = 0; i < MultiGame::DEATH_COUNT; ++i) {
+            if (total.deaths[i] == 0) continue;
+            std::printf("  %-12s %10ld  %5.1f%%\n", kDeathNames[i], total.deaths[i],
+                        100.0 * total.deaths[i] / snakes);
+        }
+        return 0;
+    }
+
+    std::printf("\noutcomes\n");
+    for (int i = 0; i < OUTCOME_COUNT; ++i) {
+        std::printf("  %-12s %10ld  %5.1f%%\n", kOutcomeNames[i], total.outcomes[i],
+                    total.games ? 100.0 * total.outcomes[i] / total.games : 0.0);
+    }
+    std::printf("\nfinal stage\n");
+    for (int i = 1; i < 8; ++i) {
+        if (total.stageReached[i] == 0) continue;
+        std::printf("  %d%-11s %10ld  %5.1f%%\n", i, i == 7 ? "+" : "", total.stageReached[i],
+                    100.0 * total.stageReached[i] / total.games);
+    }
+    return 0;
+}
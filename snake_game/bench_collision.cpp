@@ -0,0 +1,82 @@
+// 긴 뱀 자기 충돌 스트레스 벤치마크
+// 큰 빈 맵에서 뱀을 지그재그로 수만 칸까지 키우면서 길이별 틱당 비용을 잰다.
+#include "Map.h"
+#include "Snake.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+const int kHeight = 300;
+const int kWidth = 300;
+const int kTicksPerSample = 5000;
+
+// 오른쪽 끝/왼쪽 끝에 닿으면 한 줄 내려가서 반대로 도는 경로
+void steer(Snake& snake, const Map& map) {
+    auto [y, x] = snake.getBody().front();
+    (void)y;
+    switch (snake.getDirection()) {
+        case RIGHT:
+            if (x == map.getWidth() - 2) snake.updateDirection(DOWN);
+            break;
+        case LEFT:
+            if (x == 1) snake.updateDirection(DOWN);
+            break;
+        case DOWN:
+            snake.updateDirection(x == 1 ? RIGHT : LEFT);
+            break;
+        default:
+            break;
+    }
+}
+
+std::pair<int, int> nextCell(const Snake& snake) {
+    static const int dy[4] = {-1, 1, 0, 0};
+    static const int dx[4] = {0, 0, -1, 1};
+    auto [y, x] = snake.getBody().front();
+    return {y + dy[snake.getDirection()], x + dx[snake.getDirection()]};
+}
+
+bool tick(Snake& snake, Map& map, bool grow) {
+    steer(snake, map);
+    if (grow) {
+        auto [ny, nx] = nextCell(snake);
+        map.setValue(ny, nx, GROWTH_ITEM);
+    }
+    return snake.move(map) != Snake::MOVE_DEAD;
+}
+
+} // namespace
+
+int main() {
+    Map map;
+    map.createArena(kHeight, kWidth);
+
+    Snake snake;
+    snake.init(map, 1, 3);
+
+    const int targets[] = {1000, 10000, 40000};
+    std::printf("map %dx%d, %d ticks per sample\n", kHeight, kWidth, kTicksPerSample);
+    std::printf("%10s %12s\n", "length", "ns/tick");
+
+    for (int target : targets) {
+        while (snake.getLength() < target) {
+            if (!tick(snake, map, true)) {
+                std::printf("snake died while growing at length %d\n", snake.getLength());
+                return 1;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kTicksPerSample; ++i) {
+            if (!tick(snake, map, false)) {
+                std::printf("snake died at length %d\n", snake.getLength());
+                return 1;
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::printf("%10d %12.1f\n", snake.getLength(), ns / kTicksPerSample);
+    }
+    return 0;
+}
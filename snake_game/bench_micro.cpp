@@ -0,0 +1,465 @@
+// 게임 핫패스 마이크로벤치마크
+// Snake::move(일반/성장/독/게이트), 아이템 배치, 스테이지 읽기, 칸 목록 조회, 게이트 출구 표,
+// 큰 경기장, 여러 뱀 경기와 그 변경분 메시지, 화면 그리기(오프스크린 캔버스)를 맵 크기/뱀 길이별로 재서 op당 ns로 출력한다.
+#include "Bot.h"
+#include "Canvas.h"
+#include "DeltaEncoder.h"
+#include "Game.h"
+#include "GateTable.h"
+#include "Map.h"
+#include "MultiGame.h"
+#include "RemoteGame.h"
+#include "Renderer.h"
+#include "Snake.h"
+#include "StageFile.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 결과를 쓰지 않는 루프가 최적화로 사라지지 않게 여기에 남긴다
+volatile long sink;
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+void report(const char* name, const char* params, double ns) {
+    std::printf("%-26s %-22s %10.1f\n", name, params, ns);
+}
+
+// 아무것도 출력하지 않고 put 횟수만 세는 80x24 캔버스
+class NullCanvas : public Canvas {
+public:
+    long puts = 0;
+    void put(int, int, const char*) override { ++puts; }
+    void clear() override {}
+    void flush() override {}
+    int getRows() const override { return 24; }
+    int getCols() const override { return 80; }
+};
+
+// 빈 정사각형 맵에서 뱀을 지그재그로 움직인다.
+// 바닥에 가까워지면 (시간 측정 밖에서) 맵을 새로 만들고 다시 키운다.
+class SnakeRunner {
+public:
+    SnakeRunner(int size, int length) : size(size), length(length) { setup(); }
+
+    enum Kind { NORMAL, GROWTH, POISON };
+
+    // kind 종류의 이동을 ticks번 한 평균 ns
+    double run(Kind kind, long ticks) {
+        double total = 0;
+        long done = 0;
+        while (done < ticks) {
+            auto start = Clock::now();
+            while (done < ticks && roomLeft()) {
+                step(kind);
+                ++done;
+            }
+            total += elapsedNs(start);
+            if (done < ticks)
+                setup();
+        }
+        return total / ticks;
+    }
+
+    // 성장과 독을 같은 수만큼 번갈아 해서 길이를 유지한다
+    void runItems(long ticks, double& growthNs, double& poisonNs) {
+        const long kPhase = 64;
+        growthNs = poisonNs = 0;
+        for (long done = 0; done < ticks; done += kPhase) {
+            growthNs += run(GROWTH, kPhase);
+            poisonNs += run(POISON, kPhase);
+        }
+        growthNs /= ticks / kPhase;
+        poisonNs /= ticks / kPhase;
+    }
+
+private:
+    int size, length;
+    Map map;
+    Snake snake;
+
+    void setup() {
+        map.createArena(size, size);
+        snake.init(map, 1, 3);
+        while (snake.getLength() < length)
+            step(GROWTH);
+    }
+
+    // 다음 줄로 내려갈 자리가 충분히 남았는지 (몸통이 길어질 여유 포함)
+    bool roomLeft() const {
+        int row = map.rowOf(snake.getBody().frontCell());
+        return row < size - 3;
+    }
+
+    void step(Kind kind) {
+        steer();
+        if (kind != NORMAL) {
+            static const int dy[4] = {-1, 1, 0, 0};
+            static const int dx[4] = {0, 0, -1, 1};
+            int next = snake.getBody().frontCell() + dy[snake.getDirection()] * map.getStride() +
+                       dx[snake.getDirection()];
+            map.setAt(next, kind == GROWTH ? GROWTH_ITEM : POISON_ITEM);
+        }
+        snake.move(map);
+    }
+
+    void steer() {
+        int x = map.colOf(snake.getBody().frontCell());
+        switch (snake.getDirection()) {
+            case RIGHT:
+                if (x == size - 2) snake.updateDirection(DOWN);
+                break;
+            case LEFT:
+                if (x == 1) snake.updateDirection(DOWN);
+                break;
+            case DOWN:
+                snake.updateDirection(x == 1 ? RIGHT : LEFT);
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+void benchMove() {
+    const int sizes[] = {21, 100, 300, 10000};
+    const int lengths[] = {10, 1000};
+    const long kTicks = 200000;
+    char params[64];
+
+    for (int size : sizes) {
+        for (int length : lengths) {
+            // 뱀이 자리를 잡고 한 줄 이상 움직일 수 있어야 한다
+            if (length + 64 > (size - 4) * (size - 2)) continue;
+            std::snprintf(params, sizeof(params), "map %d, len %d", size, length);
+            SnakeRunner runner(size, length);
+            report("Snake::move normal", params, runner.run(SnakeRunner::NORMAL, kTicks));
+            double growthNs, poisonNs;
+            runner.runItems(kTicks, growthNs, poisonNs);
+            report("Snake::move growth", params, growthNs);
+            report("Snake::move poison", params, poisonNs);
+        }
+    }
+
+    // 한 줄짜리 통로 양 끝의 게이트를 계속 지나간다 (안쪽 4칸, 4틱마다 한 번 게이트)
+    Map map;
+    map.createArena(3, 6);
+    int left = map.index(1, 0), right = map.index(1, 5);
+    map.setAt(left, GATE);
+    map.setAt(right, GATE);
+    Snake snake;
+    snake.init(map, 1, 3);
+    snake.setGates(map, {left, right});
+    auto start = Clock::now();
+    for (long i = 0; i < kTicks; ++i)
+        snake.move(map);
+    report("Snake::move 1/4 gate", "corridor 4", elapsedNs(start) / kTicks);
+}
+
+void benchGateTable() {
+    const int pairs[] = {1, 8, 64};
+    const long kLookups = 1000000;
+    char params[64];
+
+    for (int pairCount : pairs) {
+        Map map;
+        map.createArena(300, 300);
+        Rng rng(1);
+        std::vector<int> gates;
+        GateTable::pickGates(map.getGateCandidates(), pairCount, rng, gates);
+        for (int idx : gates)
+            map.setAt(idx, GATE);
+        std::snprintf(params, sizeof(params), "%d pairs", pairCount);
+
+        GateTable table;
+        auto start = Clock::now();
+        for (int i = 0; i < 1000; ++i)
+            table.build(map, gates);
+        report("GateTable::build", params, elapsedNs(start) / 1000);
+
+        long sum = 0;
+        start = Clock::now();
+        for (long i = 0; i < kLookups; ++i)
+            sum += table.lookup(gates[i % gates.size()], static_cast<Direction>(i & 3))->cell;
+        double lookupNs = elapsedNs(start) / kLookups;
+        sink = sum;
+        report("GateTable::lookup", params, lookupNs);
+
+        start = Clock::now();
+        for (long i = 0; i < kLookups; ++i)
+            sum += GateTable::findExit(map, gates[i % gates.size()],
+                                       static_cast<Direction>(i & 3)).cell;
+        report("GateTable::findExit", params, elapsedNs(start) / kLookups);
+        sink = sum;
+    }
+}
+
+void benchItems() {
+    const int sizes[] = {21, 100, 300};
+    const long kOps = 200000;
+    char params[64];
+
+    for (int size : sizes) {
+        for (int crowded = 0; crowded < 2; ++crowded) {
+            Map map;
+            map.createArena(size, size);
+            // 빈 칸의 95%를 뱀 몸통이 차지한 것처럼 점유한다
+            if (crowded) {
+                std::vector<int> freeCells = map.cellsOf(LIST_FREE);
+                for (size_t i = 0; i < freeCells.size() * 95 / 100; ++i)
+                    map.occupy(freeCells[i]);
+            }
+            Rng rng(1);
+            std::snprintf(params, sizeof(params), "map %d, %s", size, crowded ? "95% full" : "empty");
+            auto start = Clock::now();
+            for (long i = 0; i < kOps; ++i) {
+                map.addItem(GROWTH_ITEM, rng);
+                map.clearItem(GROWTH_ITEM);
+            }
+            report("Map::addItem+clearItem", params, elapsedNs(start) / kOps);
+        }
+    }
+}
+
+void benchPositions() {
+    const int sizes[] = {21, 100, 300};
+    const int kRounds = 200;
+    char params[64];
+
+    for (int size : sizes) {
+        Map map;
+        map.createArena(size, size);
+        std::snprintf(params, sizeof(params), "map %d", size);
+        size_t count = 0;
+
+        auto start = Clock::now();
+        for (int i = 0; i < kRounds; ++i)
+            count += map.getEmptyPositions().size();
+        report("Map::getEmptyPositions", params, elapsedNs(start) / kRounds);
+
+        start = Clock::now();
+        for (int i = 0; i < kRounds; ++i)
+            count += map.getWallPositions().size();
+        report("Map::getWallPositions", params, elapsedNs(start) / kRounds);
+        sink = count;
+    }
+}
+
+void benchLoad() {
+    const int kLoads = 2000;
+    Map map;
+    Map stage;
+    stage.loadStageText("stage1.txt");
+
+    auto start = Clock::now();
+    for (int i = 0; i < kLoads; ++i)
+        map.loadStageText("stage1.txt");
+    report("Map::loadStageText", "stage1.txt", elapsedNs(start) / kLoads);
+
+    if (map.loadStageFile("stage1.stg")) {
+        start = Clock::now();
+        for (int i = 0; i < kLoads; ++i)
+            map.loadStageFile("stage1.stg");
+        report("Map::loadStageFile", "stage1.stg", elapsedNs(start) / kLoads);
+    }
+
+    if (const EmbeddedStage* embedded = findEmbeddedStage(1)) {
+        start = Clock::now();
+        for (int i = 0; i < kLoads; ++i)
+            map.loadEmbedded(*embedded);
+        report("Map::loadEmbedded", "stage 1", elapsedNs(start) / kLoads);
+    }
+
+    start = Clock::now();
+    for (int i = 0; i < kLoads; ++i)
+        map.loadFrom(stage);
+    report("Map::loadFrom", "stage 1", elapsedNs(start) / kLoads);
+}
+
+void benchRender() {
+    const int kFrames = 20000;
+    NullCanvas canvas;
+    Renderer renderer(canvas);
+    Game game;
+    game.reset(1);
+
+    auto start = Clock::now();
+    for (int i = 0; i < kFrames; ++i) {
+        renderer.invalidate();
+        renderer.draw(game);
+    }
+    report("Renderer::draw full", "stage 1", elapsedNs(start) / kFrames);
+
+    // 봇으로 한 틱씩 진행하면서 바뀐 칸만 그린다 (진행 시간은 빼고 잰다)
+    double total = 0;
+    for (int i = 0; i < kFrames; ++i) {
+        if (game.isOver())
+            game.reset(i);
+        game.step(chooseBotDirection(game));
+        auto frameStart = Clock::now();
+        renderer.draw(game);
+        total += elapsedNs(frameStart);
+    }
+    report("Renderer::draw dirty", "bot, stage 1+", total / kFrames);
+
+    // 화면보다 큰 경기장: 머리를 따라가는 창만 그린다 (창이 움직인 프레임 포함)
+    GameConfig config;
+    config.arenaHeight = config.arenaWidth = 10000;
+    Game arena(config);
+    arena.reset(1);
+    total = 0;
+    for (int i = 0; i < kFrames; ++i) {
+        if (arena.isOver())
+            arena.reset(i);
+        arena.step(chooseBotDirection(arena));
+        auto frameStart = Clock::now();
+        renderer.draw(arena);
+        total += elapsedNs(frameStart);
+    }
+    report("Renderer::draw viewport", "bot, arena 10000", total / kFrames);
+}
+
+void benchArena() {
+    const int kSize = 10000;
+    auto start = Clock::now();
+    Map stage;
+    stage.createArena(kSize, kSize);
+    report("Map::createArena", "10000x10000", elapsedNs(start));
+
+    // 첫 복사는 타일 할당이 섞이므로 빼고, 그다음부터 잰다
+    const int kLoads = 10;
+    Map map;
+    map.loadFrom(stage);
+    start = Clock::now();
+    for (int i = 0; i < kLoads; ++i)
+        map.loadFrom(stage);
+    report("Map::loadFrom", "arena 10000", elapsedNs(start) / kLoads);
+
+    const long kOps = 200000;
+    Rng rng(1);
+    start = Clock::now();
+    for (long i = 0; i < kOps; ++i) {
+        map.addItem(GROWTH_ITEM, rng);
+        map.clearItem(GROWTH_ITEM);
+    }
+    report("Map::addItem+clearItem", "arena 10000", elapsedNs(start) / kOps);
+    sink = map.getAllocatedCells();
+}
+
+// 봇 뱀 여럿이 한 경기장에서 움직이는 틱 (봇 계산은 빼고 step만 잰다).
+// 뱀 수가 늘어도 뱀 하나당 시간이 그대로인지 본다.
+void benchMulti() {
+    const int counts[] = {2, 64, 250};
+    const int kTicks = 20000;
+    char params[64];
+
+    for (int count : counts) {
+        MultiConfig config;
+        config.snakeCount = count;
+        config.arenaHeight = config.arenaWidth = 300;
+        MultiGame match(config);
+        std::vector<Direction> actions(count);
+        uint64_t seed = 1;
+        match.reset(seed);
+
+        double total = 0;
+        long moves = 0;
+        for (int i = 0; i < kTicks; ++i) {
+            if (match.isOver())
+                match.reset(++seed);
+            for (int id = 0; id < count; ++id) {
+                const MultiGame::Player& player = match.getPlayer(id);
+                if (player.isAlive())
+                    actions[id] = chooseBotDirection(match.getMap(), player.snake, LIST_GROWTH);
+            }
+            moves += match.getAliveCount();
+            auto start = Clock::now();
+            match.step(actions.data());
+            total += elapsedNs(start);
+        }
+        std::snprintf(params, sizeof(params), "%d snakes, arena 300", count);
+        report("MultiGame::step", params, total / kTicks);
+        report("MultiGame::step / snake", params, total / moves);
+    }
+}
+
+// 서버가 틱마다 만드는 변경분 메시지와 클라이언트가 그것을 적용하는 시간.
+// 맵이 커져도 틱 메시지 크기와 시간은 움직인 뱀 수에만 비례해야 한다.
+void benchDelta() {
+    const int sizes[] = {300, 5000};
+    const int kTicks = 5000;
+    const int kSnakes = 64;
+    char params[64];
+
+    for (int size : sizes) {
+        MultiConfig config;
+        config.snakeCount = kSnakes;
+        config.arenaHeight = config.arenaWidth = size;
+        MultiGame match(config);
+        DeltaEncoder encoder;
+        RemoteGame remote;
+        MessageWriter message;
+        std::vector<Direction> actions(kSnakes);
+        uint64_t seed = 1;
+
+        double encodeNs = 0, applyNs = 0;
+        long bytes = 0;
+        for (int i = 0; i < kTicks; ++i) {
+            message.clear();
+            if (i == 0 || match.isOver()) {
+                match.reset(seed++);
+                encoder.welcome(match, 0, message);
+                encoder.snapshot(match, message);
+            } else {
+                for (int id = 0; id < kSnakes; ++id) {
+                    const MultiGame::Player& player = match.getPlayer(id);
+                    if (player.isAlive())
+                        actions[id] = chooseBotDirection(match.getMap(), player.snake, LIST_GROWTH);
+                }
+                match.step(actions.data());
+                auto start = Clock::now();
+                encoder.tick(match, message);
+                encodeNs += elapsedNs(start);
+                bytes += message.size();
+            }
+            match.markRendered();
+
+            auto start = Clock::now();
+            for (std::size_t pos = 0; pos < message.size();) {
+                std::size_t frame = MessageReader::frameSize(message.data() + pos, message.size() - pos);
+                MessageReader reader(message.data() + pos + kFrameHeader, frame - kFrameHeader);
+                remote.apply(message.data()[pos], reader);
+                pos += frame;
+            }
+            remote.getMap().clearDirty();
+            if (message.data()[0] == MSG_TICK)
+                applyNs += elapsedNs(start);
+        }
+        std::snprintf(params, sizeof(params), "%d snakes, arena %d", kSnakes, size);
+        report("DeltaEncoder::tick", params, encodeNs / kTicks);
+        report("RemoteGame::apply tick", params, applyNs / kTicks);
+        report("tick message (bytes)", params, double(bytes) / kTicks);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-26s %-22s %10s\n", "benchmark", "params", "ns/op");
+    benchMove();
+    benchGateTable();
+    benchItems();
+    benchPositions();
+    benchLoad();
+    benchArena();
+    benchMulti();
+    benchDelta();
+    benchRender();
+    return 0;
+}
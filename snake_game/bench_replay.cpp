@@ -0,0 +1,400 @@
+// 기록된 게임을 틱 파이프라인 전체로 재생하는 처리량 벤치마크
+// Game::step(이동, 아이템 재배치, 게이트, 미션 확인, 스테이지 전환) -> (선택) 화면 그리기를
+// 틱마다 재서 ticks/sec, p50/p99 틱 시간, 틱당 메모리 할당 횟수를 출력한다.
+// 기록에는 틱마다 적용된 방향만 있고 키를 누른 시각은 없으므로 GameManager의 입력 처리
+// (InputThread, TurnQueue)는 재지 않는다.
+//
+//   bench_replay [-n games] [-r reference [-k rounds] [-l limit%] [-p p99limit%]] [replay.rpl...]
+//
+// 기록 파일을 주지 않으면 봇으로 시드 1부터 끝난 게임 n개를 기록해서 쓴다 (같은 n이면 항상 같은 게임).
+// -r을 주면 직접 재지 않고 이 실행 파일과 기준 실행 파일(보통 이전 리비전으로 빌드한 bench_replay)을
+// 번갈아 돌려 비교하고, 처리량/p50/p99/할당 횟수 중 하나라도 한도 넘게 나빠지면 1로 끝난다.
+#include "Bot.h"
+#include "Canvas.h"
+#include "Game.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<long> allocationCount{0};
+
+} // namespace
+
+// 틱당 할당 횟수를 세기 위해 전역 new를 가로챈다
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// 위의 new가 malloc으로 받은 메모리라 free가 맞다 (GCC가 짝이 안 맞는다고 잘못 경고한다)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int kRepeats = 5;  // 모드마다 여러 번 돌려서 항목마다 가장 좋은 값을 쓴다 (잡음 줄이기)
+
+// 아무것도 출력하지 않는 80x24 캔버스
+class NullCanvas : public Canvas {
+public:
+    void put(int, int, const char*) override {}
+    void clear() override {}
+    void flush() override {}
+    int getRows() const override { return 24; }
+    int getCols() const override { return 80; }
+};
+
+struct Metrics {
+    double ticksPerSec = 0;
+    double p50Ns = 0;
+    double p99Ns = 0;
+    double allocsPerTick = 0;
+};
+
+// 틱 제한에 걸려 끝나지 않은 게임은 기록할 결과가 없으므로 false
+bool recordBotGame(uint64_t seed, Replay& replay) {
+    const long kMaxTicks = 5000;
+    Game game;
+    game.reset(seed);
+    ReplayRecorder recorder;
+    recorder.begin(game, seed);
+    while (!game.isOver() && game.getTick() < kMaxTicks) {
+        Direction action = chooseBotDirection(game);
+        recorder.recordInput(game, action);
+        recorder.recordEvents(game, game.step(action));
+    }
+    replay = recorder.getReplay();
+    return game.isOver();
+}
+
+// 모든 기록을 재생한다. render면 틱마다 오프스크린 캔버스에 그린다.
+// 재생 결과가 기록과 다르면 false
+bool run(const std::vector<Replay>& corpus, bool render, Metrics& metrics) {
+    NullCanvas canvas;
+    Renderer renderer(canvas);
+    std::vector<float> tickNs;
+    bool allMatch = true;
+
+    long ticks = 0;
+    long allocations = 0;
+    double totalNs = 0;
+
+    for (const Replay& replay : corpus) {
+        Game game(replay.config);
+        game.reset(replay.seed);
+        ReplayPlayer player(replay);
+        std::vector<int> stages = {game.getStage()};
+        renderer.invalidate();
+        tickNs.reserve(tickNs.size() + replay.result.tick + 1);
+
+        long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        while (!game.isOver() && game.getTick() <= replay.result.tick) {
+            auto start = Clock::now();
+            StepEvents events = game.step(player.nextAction(game));
+            if (render && !events.stageCleared)
+                renderer.draw(game);
+
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            tickNs.push_back(ns);
+            totalNs += ns;
+            ++ticks;
+
+            if (events.stageCleared)
+                stages.push_back(game.getStage());
+        }
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        if (resultOf(game, stages) != replay.result)
+            allMatch = false;
+    }
+
+    if (tickNs.empty()) return false;
+    std::sort(tickNs.begin(), tickNs.end());
+    metrics.ticksPerSec = ticks / (totalNs * 1e-9);
+    metrics.p50Ns = tickNs[tickNs.size() / 2];
+    metrics.p99Ns = tickNs[tickNs.size() * 99 / 100];
+    metrics.allocsPerTick = double(allocations) / ticks;
+    return allMatch;
+}
+
+// 한 번 실행한 결과. 기록 묶음 크기(같아야 비교한다)와 모드별 값
+struct RunResult {
+    long games = 0, ticks = 0;
+    std::map<std::string, Metrics> modes;
+};
+
+std::string shellQuote(const std::string& arg) {
+    std::string quoted = "'";
+    for (char c : arg) {
+        if (c == '\'')
+            quoted += "'\\''";
+        else
+            quoted += c;
+    }
+    return quoted + "'";
+}
+
+// 벤치마크 하나를 자식 프로세스로 돌리고 출력한 표를 읽는다.
+// 이전 리비전의 bench_replay도 읽을 수 있게 사람이 보는 출력(corpus 줄과 모드 줄)을 그대로 쓴다.
+// 자식이 실패로 끝나면(재생 결과가 기록과 다르면) false
+bool runChild(const std::string& command, RunResult& result) {
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) return false;
+    result = RunResult();
+    char buffer[512];
+    while (std::fgets(buffer, sizeof(buffer), pipe)) {
+        std::istringstream row(buffer);
+        std::string first, word, previous;
+        row >> first;
+        if (first == "corpus") {
+            // "... 200 games, 70035 ticks, ..."
+            while (row >> word) {
+                if (word == "games,") result.games = std::atol(previous.c_str());
+                if (word == "ticks,") result.ticks = std::atol(previous.c_str());
+                previous = word;
+            }
+        } else if (first == "headless" || first == "rendered") {
+            Metrics m;
+            if (row >> m.ticksPerSec >> m.p50Ns >> m.p99Ns >> m.allocsPerTick)
+                result.modes[first] = m;
+        }
+    }
+    return pclose(pipe) == 0 && result.modes.size() == 2;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// 라운드마다 잰 값을 항목별 중앙값으로 합친다
+Metrics medianOf(const std::vector<RunResult>& runs, const std::string& mode) {
+    std::vector<double> tps, p50, p99, allocs;
+    for (const RunResult& run : runs) {
+        const Metrics& m = run.modes.at(mode);
+        tps.push_back(m.ticksPerSec);
+        p50.push_back(m.p50Ns);
+        p99.push_back(m.p99Ns);
+        allocs.push_back(m.allocsPerTick);
+    }
+    Metrics m;
+    m.ticksPerSec = median(tps);
+    m.p50Ns = median(p50);
+    m.p99Ns = median(p99);
+    m.allocsPerTick = median(allocs);
+    return m;
+}
+
+// 같은 라운드에서 잰 이 실행 파일/기준 비율의 중앙값. 라운드 사이에 기계 속도가 바뀌어도
+// 바로 옆에서 잰 두 값끼리 나누므로 상쇄된다
+Metrics medianRatio(const std::vector<RunResult>& runs, const std::vector<RunResult>& refs,
+                    const std::string& mode) {
+    std::vector<double> tps, p50, p99;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        const Metrics& m = runs[i].modes.at(mode);
+        const Metrics& b = refs[i].modes.at(mode);
+        tps.push_back(m.ticksPerSec / b.ticksPerSec);
+        p50.push_back(m.p50Ns / b.p50Ns);
+        p99.push_back(m.p99Ns / b.p99Ns);
+    }
+    Metrics ratio;
+    ratio.ticksPerSec = median(tps);
+    ratio.p50Ns = median(p50);
+    ratio.p99Ns = median(p99);
+    return ratio;
+}
+
+// 처리량은 낮아지면, 틱 시간은 늘어나면 나빠진 것
+bool regressed(double ratio, bool higherIsBetter, double limit) {
+    return higherIsBetter ? ratio < 1 - limit : ratio > 1 + limit;
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n games] [-r reference [-k rounds] [-l limit%%] [-p p99limit%%]] "
+                 "[replay.rpl...]\n", prog);
+}
+
+// 이 실행 파일과 기준 실행 파일을 번갈아 rounds번씩 돌려 항목별 중앙값을 비교한다.
+// 같은 기계에서 같은 때 잰 값끼리만 비교하므로 기계마다 기준 숫자를 저장해 둘 필요가 없다.
+// 순서는 라운드마다 바꾼다 (ABBA). 시간이 지나며 기계가 느려지거나 빨라져도 한쪽만 손해 보지 않게.
+int compareWith(const std::string& reference, const std::string& args, int rounds, double limit,
+                double p99Limit) {
+    // popen의 셸에서는 /proc/self/exe가 셸 자신이므로 경로를 먼저 풀어 둔다
+    char selfPath[4096];
+    ssize_t length = readlink("/proc/self/exe", selfPath, sizeof(selfPath) - 1);
+    if (length <= 0) {
+        std::perror("readlink /proc/self/exe");
+        return 1;
+    }
+    selfPath[length] = '\0';
+    const std::string commands[2] = {shellQuote(reference) + args, shellQuote(selfPath) + args};
+    const char* names[2] = {"reference", "this"};
+    std::vector<RunResult> runs[2];
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < 2; ++i) {
+            int side = (round % 2) ? 1 - i : i;
+            RunResult result;
+            if (!runChild(commands[side], result)) {
+                std::fprintf(stderr, "%s run failed: %s\n", names[side], commands[side].c_str());
+                return 1;
+            }
+            runs[side].push_back(result);
+        }
+        std::fprintf(stderr, "\rround %d/%d", round + 1, rounds);
+    }
+    std::fprintf(stderr, "\n");
+
+    const RunResult& ref = runs[0].front();
+    const RunResult& self = runs[1].front();
+    if (ref.games != self.games || ref.ticks != self.ticks) {
+        std::fprintf(stderr, "corpora differ: reference %ld games %ld ticks, this %ld games %ld ticks\n",
+                     ref.games, ref.ticks, self.games, self.ticks);
+        return 1;
+    }
+    std::printf("corpus     %ld games, %ld ticks; medians of %d interleaved rounds\n\n", self.games,
+                self.ticks, rounds);
+
+    bool ok = true;
+    std::printf("%-10s %12s %10s %10s %12s\n", "mode", "ticks/sec", "p50 ns", "p99 ns", "allocs/tick");
+    for (const char* mode : {"headless", "rendered"}) {
+        Metrics b = medianOf(runs[0], mode);
+        Metrics m = medianOf(runs[1], mode);
+        std::printf("%-10s %12.0f %10.0f %10.0f %12.3f\n", mode, m.ticksPerSec, m.p50Ns, m.p99Ns,
+                    m.allocsPerTick);
+        std::printf("%-10s %12.0f %10.0f %10.0f %12.3f\n", "  ref", b.ticksPerSec, b.p50Ns, b.p99Ns,
+                    b.allocsPerTick);
+        Metrics ratio = medianRatio(runs[1], runs[0], mode);
+        std::printf("%-10s %+11.1f%% %+9.1f%% %+9.1f%%\n", "  vs ref", 100 * (ratio.ticksPerSec - 1),
+                    100 * (ratio.p50Ns - 1), 100 * (ratio.p99Ns - 1));
+        if (regressed(ratio.ticksPerSec, true, limit) || regressed(ratio.p50Ns, false, limit) ||
+            regressed(ratio.p99Ns, false, p99Limit) ||
+            m.allocsPerTick > b.allocsPerTick + 0.01) {
+            std::printf("%-10s REGRESSION\n", "");
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int games = 200;
+    const char* reference = nullptr;
+    int rounds = 15;
+    double limit = 0.10;     // 처리량, p50이 기준보다 이만큼 넘게 나빠지면 실패
+    double p99Limit = 0.25;  // p99는 선점과 캐시 밀림을 그대로 받아 흔들림이 커서 한도를 따로 둔다
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:k:l:p:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                games = std::atoi(optarg);
+                if (games < 1) {
+                    std::fprintf(stderr, "games must be at least 1\n");
+                    return 1;
+                }
+                break;
+            case 'r': reference = optarg; break;
+            case 'k':
+                rounds = std::atoi(optarg);
+                if (rounds < 1) {
+                    std::fprintf(stderr, "rounds must be at least 1\n");
+                    return 1;
+                }
+                break;
+            case 'l': limit = std::atof(optarg) / 100; break;
+            case 'p': p99Limit = std::atof(optarg) / 100; break;
+            default:  usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (reference) {
+        std::string args = " -n " + std::to_string(games);
+        for (int i = optind; i < argc; ++i)
+            args += " " + shellQuote(argv[i]);
+        return compareWith(reference, args, rounds, limit, p99Limit);
+    }
+
+    std::vector<Replay> corpus;
+    for (int i = optind; i < argc; ++i) {
+        Replay replay;
+        if (!loadReplay(argv[i], replay)) {
+            std::fprintf(stderr, "failed to read replay %s\n", argv[i]);
+            return 1;
+        }
+        corpus.push_back(replay);
+    }
+    if (corpus.empty()) {
+        Replay replay;
+        for (uint64_t seed = 1; static_cast<int>(corpus.size()) < games; ++seed) {
+            if (recordBotGame(seed, replay))
+                corpus.push_back(replay);
+        }
+    }
+
+    long corpusTicks = 0;
+    int stagesSeen[8] = {};
+    for (const Replay& replay : corpus) {
+        corpusTicks += replay.result.tick;
+        for (int stage : replay.result.stages)
+            ++stagesSeen[stage < 7 ? stage : 7];
+    }
+    std::printf("corpus     %s, %zu games, %ld ticks, stage entries", optind < argc ? "files" : "bot",
+                corpus.size(), corpusTicks);
+    for (int s = 1; s < 8; ++s)
+        if (stagesSeen[s]) std::printf(" %d:%d", s, stagesSeen[s]);
+    std::printf("\n\n");
+    if (corpusTicks == 0) {
+        std::fprintf(stderr, "no ticks to replay\n");
+        return 1;
+    }
+
+    // 처음 도는 모드가 캐시와 CPU 클럭을 데우는 값을 치르지 않게 한 번 먼저 돌린다
+    Metrics warmup;
+    run(corpus, true, warmup);
+
+    bool ok = true;
+    std::printf("%-10s %12s %10s %10s %12s\n", "mode", "ticks/sec", "p50 ns", "p99 ns", "allocs/tick");
+    for (int render = 0; render < 2; ++render) {
+        const char* mode = render ? "rendered" : "headless";
+        Metrics m;
+        for (int r = 0; r < kRepeats; ++r) {
+            Metrics trial;
+            if (!run(corpus, render, trial)) {
+                std::printf("%s: replay result mismatch\n", mode);
+                ok = false;
+                break;
+            }
+            if (r == 0) {
+                m = trial;
+                continue;
+            }
+            m.ticksPerSec = std::max(m.ticksPerSec, trial.ticksPerSec);
+            m.p50Ns = std::min(m.p50Ns, trial.p50Ns);
+            m.p99Ns = std::min(m.p99Ns, trial.p99Ns);
+            m.allocsPerTick = std::min(m.allocsPerTick, trial.allocsPerTick);
+        }
+        std::printf("%-10s %12.0f %10.0f %10.0f %12.3f\n", mode, m.ticksPerSec, m.p50Ns, m.p99Ns,
+                    m.allocsPerTick);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// 서버 변경분 메시지(DeltaEncoder)를 받아 그린 원격 맵(RemoteGame)이 서버 맵과 같은지 확인한다.
+// 소켓 없이 한 프로세스에서 봇 경기를 돌리며 매 틱 메시지를 클라이언트 둘(처음부터 본 쪽, 50틱에 들어온 쪽)에
+// 먹이고, 칸 값/점유/머리/길이/빈 칸 수를 서버와 비교한다. 어긋나면 개수를 출력하고 1로 끝난다.
+// 사용법: check_mirror [-l]   (-l: 5000x5000 경기장, 칸은 띄엄띄엄 비교한다)
+#include "Bot.h"
+#include "DeltaEncoder.h"
+#include "MultiGame.h"
+#include "RemoteGame.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const int kSeeds = 20;
+const int kMaxTicks = 2000;
+const int kLateJoinTick = 50;
+
+// 메시지 버퍼에 든 프레임을 모두 적용한다. 깨진 프레임이 있거나 끝이 남으면 false
+bool feed(RemoteGame& remote, const MessageWriter& message) {
+    std::size_t pos = 0;
+    while (std::size_t size = MessageReader::frameSize(message.data() + pos, message.size() - pos)) {
+        MessageReader reader(message.data() + pos + kFrameHeader, size - kFrameHeader);
+        if (!remote.apply(message.data()[pos], reader)) return false;
+        pos += size;
+    }
+    return pos == message.size();
+}
+
+// 어긋난 항목 수를 돌려준다. step칸마다 한 칸씩 비교한다
+long compare(const MultiGame& game, RemoteGame& remote, int step) {
+    const Map& map = game.getMap();
+    Map& mirror = remote.getMap();
+    long bad = 0;
+    for (int y = 0; y < map.getHeight(); y += step) {
+        for (int x = 0; x < map.getWidth(); x += step) {
+            int idx = map.index(y, x), mirrored = mirror.index(y, x);
+            if (map.at(idx) != mirror.at(mirrored) || map.ownerAt(idx) != mirror.ownerAt(mirrored))
+                ++bad;
+        }
+    }
+    for (int id = 0; id < game.getSnakeCount(); ++id) {
+        const MultiGame::Player& player = game.getPlayer(id);
+        int head = player.isAlive() ? player.snake.getBody().frontCell() : -1;
+        int remoteHead = remote.getHeads()[id];
+        if ((head < 0) != (remoteHead < 0) ||
+            (head >= 0 && (map.rowOf(head) != mirror.rowOf(remoteHead) ||
+                           map.colOf(head) != mirror.colOf(remoteHead))))
+            ++bad;
+        if (int(remote.getSnake(id).length) != (player.isAlive() ? player.snake.getLength() : 0))
+            ++bad;
+    }
+    if (mirror.getFreeCount() != map.getFreeCount()) ++bad;
+    return bad;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool large = argc > 1 && std::strcmp(argv[1], "-l") == 0;
+    MultiConfig config;
+    config.snakeCount = 32;
+    config.arenaHeight = large ? 5000 : 60;
+    config.arenaWidth = large ? 5000 : 80;
+    int step = large ? 89 : 1;
+
+    MultiGame game(config);
+    DeltaEncoder encoder;
+    MessageWriter message;
+    std::vector<Direction> actions(config.snakeCount);
+    long ticks = 0, bytes = 0, bad = 0;
+
+    for (int seed = 1; seed <= kSeeds; ++seed) {
+        game.reset(seed);
+        message.clear();
+        encoder.welcome(game, 0, message);
+        encoder.snapshot(game, message);
+        game.markRendered();
+        RemoteGame early, late;
+        bool lateJoined = false;
+        if (!feed(early, message)) {
+            std::printf("seed %d: snapshot rejected\n", seed);
+            return 1;
+        }
+
+        while (!game.isOver() && game.getTick() < kMaxTicks) {
+            for (int id = 0; id < config.snakeCount; ++id) {
+                const MultiGame::Player& player = game.getPlayer(id);
+                if (player.isAlive())
+                    actions[id] = chooseBotDirection(game.getMap(), player.snake, LIST_GROWTH);
+            }
+            game.step(actions.data());
+            message.clear();
+            encoder.tick(game, message);
+            game.markRendered();
+            bytes += message.size();
+            ++ticks;
+
+            if (!feed(early, message) || (lateJoined && !feed(late, message))) {
+                std::printf("seed %d tick %ld: delta rejected\n", seed, game.getTick());
+                return 1;
+            }
+            if (game.getTick() == kLateJoinTick) {
+                message.clear();
+                encoder.welcome(game, 1, message);
+                encoder.snapshot(game, message);
+                if (!feed(late, message)) {
+                    std::printf("seed %d: late snapshot rejected\n", seed);
+                    return 1;
+                }
+                lateJoined = true;
+            }
+            bad += compare(game, early, step);
+            if (lateJoined) bad += compare(game, late, step);
+        }
+    }
+
+    std::printf("arena %dx%d, %ld ticks, %.1f bytes/tick, %ld mismatches\n", config.arenaHeight,
+                config.arenaWidth, ticks, double(bytes) / ticks, bad);
+    return bad ? 1 : 0;
+}
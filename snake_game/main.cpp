@@ -1,8 +1,154 @@
+#include "GameClient.h"
 #include "GameManager.h"
+#include "GameServer.h"
+#include "Replay.h"
+#include "SessionHost.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 
-int main() {
-    GameManager game;
-    game.run();  // 게임 실행 시작
-    return 0;
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--tick-ms N] [--seed N] [--record FILE] [--arena HxW] [--bots N]\n"
+            "       %s --replay FILE [--watch] [--tick-ms N]\n"
+            "       %s --serve PATH|PORT [--snakes N] [--tick-ms N] [--seed N] [--arena HxW]\n"
+            "       %s --connect PATH|PORT\n"
+            "       %s --host PATH|PORT [--threads N] [--tick-ms N] [--seed N] [--arena HxW]\n",
+            prog, prog, prog, prog, prog);
 }
 
+static void printResult(const char* label, const ReplayResult& result) {
+    printf("%-9s stage %d, tick %ld, length %d, +%d -%d G%d, end %d\n", label, result.stage,
+           result.tick, result.length, result.growth, result.poison, result.gate, result.reason);
+}
+
+// 기록을 재생해서 저장된 결과와 같은지 확인한다. 같으면 0
+static int runReplay(const char* path, const GameOptions& options, bool watch) {
+    Replay replay;
+    if (!loadReplay(path, replay)) {
+        fprintf(stderr, "failed to read replay %s\n", path);
+        return 1;
+    }
+
+    bool match;
+    if (watch) {
+        GameManager manager(options);
+        match = manager.watch(replay);
+        printResult("recorded", replay.result);
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        ReplayResult result = playReplay(replay);
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        match = result == replay.result;
+        printResult("recorded", replay.result);
+        printResult("replayed", result);
+        printf("%ld ticks in %.2f ms\n", result.tick, ms);
+    }
+    printf("%s\n", match ? "match" : "MISMATCH");
+    return match ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    GameOptions options;
+    const char* replayPath = nullptr;
+    const char* serveAddress = nullptr;
+    const char* connectAddress = nullptr;
+    const char* hostAddress = nullptr;
+    int snakes = 8;
+    int threads = 0;
+    bool watch = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            options.tickMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.fixedSeed = true;
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--arena") == 0 && i + 1 < argc) {
+            // 가장자리만 벽인 빈 경기장. 화면보다 크면 머리를 따라 스크롤한다.
+            if (sscanf(argv[++i], "%dx%d", &options.arenaHeight, &options.arenaWidth) != 2 ||
+                options.arenaHeight < 8 || options.arenaWidth < 8 ||
+                !Map::fitsIndex(options.arenaHeight, options.arenaWidth)) {
+                fprintf(stderr, "bad arena size %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc) {
+            options.bots = atoi(argv[++i]);
+            if (options.bots < 0 || options.bots >= Map::kMaxOwners) {
+                fprintf(stderr, "bots must be 0..%d\n", Map::kMaxOwners - 1);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            connectAddress = argv[++i];
+        } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            hostAddress = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) {
+                fprintf(stderr, "threads must be at least 1\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--snakes") == 0 && i + 1 < argc) {
+            snakes = atoi(argv[++i]);
+            if (snakes < 1 || snakes > Map::kMaxOwners) {
+                fprintf(stderr, "snakes must be 1..%d\n", Map::kMaxOwners);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            watch = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.tickMs <= 0 || (watch && !replayPath)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // 스테이지를 읽지 못하는 등 시작할 수 없으면 예외로 알린다
+    try {
+        if (replayPath)
+            return runReplay(replayPath, options, watch);
+
+        if (serveAddress) {
+            ServerOptions server;
+            server.address = serveAddress;
+            server.tickMs = options.tickMs;
+            server.snakes = snakes;
+            server.arenaHeight = options.arenaHeight;
+            server.arenaWidth = options.arenaWidth;
+            server.fixedSeed = options.fixedSeed;
+            server.seed = options.seed;
+            return GameServer(server).run();
+        }
+        if (hostAddress) {
+            HostOptions host;
+            host.address = hostAddress;
+            host.tickMs = options.tickMs;
+            host.threads = threads;
+            host.arenaHeight = options.arenaHeight;
+            host.arenaWidth = options.arenaWidth;
+            host.fixedSeed = options.fixedSeed;
+            host.seed = options.seed;
+            return SessionHost(host).run();
+        }
+        if (connectAddress)
+            return GameClient(connectAddress).run();
+
+        GameManager game(options);
+        game.run();  // 게임 실행 시작
+        return 0;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
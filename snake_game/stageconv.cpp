@@ -0,0 +1,75 @@
+// 텍스트 스테이지(stageN.txt)를 바이너리 스테이지(stageN.stg)로 변환한다
+//   usage: stageconv input.txt output.stg [spawnY spawnX [gatePairs]]
+//          stageconv -c output.h stage1.txt stage2.txt ...   (constexpr 배열 헤더로 내장)
+#include "Map.h"
+#include "StageFile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "usage: %s input.txt output.stg [spawnY spawnX [gatePairs]]\n"
+                 "       %s -c output.h input.txt...\n", prog, prog);
+}
+
+bool readStage(const char* path, Map& map) {
+    if (!map.loadStageText(path)) {
+        std::fprintf(stderr, "failed to read %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// 시작 위치에서 왼쪽으로 몸통 두 칸이 놓일 자리가 비어 있어야 한다
+bool checkSpawn(const char* path, const Map& map) {
+    int y = map.getSpawnY(), x = map.getSpawnX();
+    for (int i = 0; i < 3; ++i) {
+        if (map.getValue(y, x - i) != EMPTY) {
+            std::fprintf(stderr, "%s: spawn (%d, %d) is blocked\n", path, y, x);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc >= 4 && std::strcmp(argv[1], "-c") == 0) {
+        std::vector<Map> maps(argc - 3);
+        for (int i = 3; i < argc; ++i) {
+            if (!readStage(argv[i], maps[i - 3]) || !checkSpawn(argv[i], maps[i - 3]))
+                return 1;
+        }
+        if (!saveEmbeddedStages(argv[2], maps)) {
+            std::fprintf(stderr, "failed to write %s\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc != 3 && argc != 5 && argc != 6) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Map map;
+    if (!readStage(argv[1], map))
+        return 1;
+    if (argc >= 5)
+        map.setSpawn(std::atoi(argv[3]), std::atoi(argv[4]));
+    if (argc == 6)
+        map.setGatePairs(std::atoi(argv[5]));
+    if (!checkSpawn(argv[1], map))
+        return 1;
+
+    if (!saveStageFile(argv[2], map)) {
+        std::fprintf(stderr, "failed to write %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}